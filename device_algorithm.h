@@ -1,14 +1,55 @@
 #pragma once
 #include "device_utility.h"
 #include "device_type_traits.h"
+#include "device_iterator.h"
+#include "device_bit.h"
+#include "device_simd.h"
+#include "device_execution.h"
 
 
 
 namespace cudlb
 {
+	/**
+	*	True if the elements of In can be copied to Out as bytes: both are contiguous iterators
+	*	and their elements are of the same trivially copyable type.
+	*/
+	template<typename In, typename Out>
+	struct bitwise_copyable : cudlb::integral_constant<bool,
+		cudlb::is_iterator_category<In, cudlb::contiguous_iterator_tag>::value &&
+		cudlb::is_iterator_category<Out, cudlb::contiguous_iterator_tag>::value &&
+		cudlb::is_same<typename cudlb::remove_cv<typename cudlb::remove_reference<decltype(*cudlb::declval<In&>())>::value_type>::value_type,
+			typename cudlb::remove_reference<decltype(*cudlb::declval<Out&>())>::value_type>::value &&
+		cudlb::is_trivially_copyable<typename cudlb::remove_reference<decltype(*cudlb::declval<Out&>())>::value_type>::value> {};
+
+	template<typename In, typename Out>
+	__host__ __device__
+	Out copy(In iterator_first, In iterator_last, Out destination, cudlb::false_type)
+	{
+		for(; iterator_first != iterator_last; ++destination, ++iterator_first)
+			*destination = *iterator_first;
+		
+		return destination;
+	}
+
+	template<typename In, typename Out>
+	__host__ __device__
+	Out copy(In iterator_first, In iterator_last, Out destination, cudlb::true_type)
+	{
+	#if defined(__CUDA_ARCH__)
+		return cudlb::copy(iterator_first, iterator_last, destination, cudlb::false_type());
+	#else
+		size_t const n = static_cast<size_t>(iterator_last - iterator_first);
+		if (n != 0)
+			memmove(cudlb::to_address(destination), cudlb::to_address(iterator_first), n * sizeof(*cudlb::to_address(iterator_first)));
+		return destination + n;
+	#endif
+	}
+
 	/**
 	*	Basic implementation of copy algorithm.
 	*	Copies elements from source container to destination.
+	*	Contiguous ranges of trivially copyable elements are copied with one memmove in host builds.
 	*	@iterator_first - points to first element in source container.
 	*	@iterator_last - points to one past source container's last element.
 	*	@destination - is the destination array where the elements are copied to.
@@ -18,10 +59,32 @@ namespace cudlb
 	__host__ __device__
 	Out copy(In iterator_first, In iterator_last, Out destination)
 	{
-		for(; iterator_first != iterator_last; ++destination, ++iterator_first)
-			*destination = *iterator_first;
+		return cudlb::copy(iterator_first, iterator_last, destination, cudlb::bitwise_copyable<In, Out>());
+	}
+
+	template<typename In, typename Out>
+	__host__ __device__
+	Out uninitialized_copy(In iterator_first, In iterator_last, Out destination, cudlb::false_type)
+	{
+		using value_type = typename cudlb::iterator_traits<Out>::value_type; 
 		
-		return destination;
+		for (; iterator_first != iterator_last; ++destination, ++iterator_first)
+			::new(static_cast<void*>(destination))value_type(*iterator_first);
+
+		return destination; 
+	}
+
+	/**
+	*	Trivially copyable elements need no constructor call, the contiguous range is copied with one memcpy.
+	*/
+	template<typename In, typename Out>
+	__host__ __device__
+	Out uninitialized_copy(In iterator_first, In iterator_last, Out destination, cudlb::true_type)
+	{
+		size_t const n = static_cast<size_t>(iterator_last - iterator_first);
+		if (n != 0)
+			memcpy(cudlb::to_address(destination), cudlb::to_address(iterator_first), n * sizeof(*cudlb::to_address(iterator_first)));
+		return destination + n;
 	}
 
 	/**
@@ -37,12 +100,7 @@ namespace cudlb
 	__host__ __device__ 
 	Out uninitialized_copy(In iterator_first, In iterator_last, Out destination)
 	{
-		using value_type = typename cudlb::iterator_traits<Out>::value_type; 
-		
-		for (; iterator_first != iterator_last; ++destination, ++iterator_first)
-			::new(static_cast<void*>(destination))value_type(*iterator_first);
-
-		return destination; 
+		return cudlb::uninitialized_copy(iterator_first, iterator_last, destination, cudlb::bitwise_copyable<In, Out>());
 	}
 	
 	/**
@@ -59,17 +117,97 @@ namespace cudlb
 		second = cudlb::move(temp);
 	}
 
+	template<typename Iterator> 
+	__host__ __device__ 
+	bool lexicographical_compare(Iterator first_a, Iterator last_a, Iterator first_b, Iterator last_b, cudlb::input_iterator_tag)
+	{
+		for (; first_a != last_a && first_b != last_b; ++first_a, ++first_b)
+		{
+			if (*first_a < *first_b) return true;
+			if (*first_b < *first_a) return false;
+		}
+		return (first_a == last_a) && (first_b != last_b);
+	}
+
+
 	/**
-	*	Checks if the first range provided is lexicographically LESS than the second. 
-	*	@[first_a : last_a) - first range of elements. 
-	*	@[first_b : last_b) - second range of elements. 
-	*	Returns true if first range is lexicographically LESS than the second. 
-	*	Returns false if the two ranges are lexicographically equal.
-	*	Returns false if the second range is LESS than the first. 
+	*	Ranges whose lengths are not known in advance are walked together, until one of them ends.
 	*/
 	template<typename Iterator> 
 	__host__ __device__ 
-	bool lexicographical_compare(Iterator first_a, Iterator last_a, Iterator first_b, Iterator last_b)
+	bool equal(Iterator first_a, Iterator last_a, Iterator first_b, Iterator last_b, cudlb::input_iterator_tag)
+	{
+		for (; first_a != last_a && first_b != last_b; ++first_a, ++first_b)
+			if (*first_a != *first_b) return false; 
+
+		return first_a == last_a && first_b == last_b;
+	}
+
+	/**
+	*	Random access ranges of different lengths are told apart without reading any element.
+	*/
+	template<typename Iterator>
+	__host__ __device__
+	bool equal(Iterator first_a, Iterator last_a, Iterator first_b, Iterator last_b, cudlb::random_access_iterator_tag)
+	{
+		if (last_a - first_a != last_b - first_b) return false;
+		for (; first_a != last_a; ++first_a, ++first_b)
+			if (*first_a != *first_b) return false;
+		return true;
+	}
+
+	/**
+	*	Returns the offset of the first byte at which two byte ranges differ, or @n if they are equal.
+	*	Compares 16 bytes per step as two 64-bit words, the first differing byte of a word is found
+	*	with count-trailing-zeros of the XOR of the words.
+	*	NOTE: Assumes a little-endian target, as are x86, ARM in its default mode and all CUDA devices.
+	*/
+	__host__ __device__
+	inline size_t mismatch_bytes(unsigned char const* a, unsigned char const* b, size_t const n)
+	{
+		size_t i = 0;
+		for (; i + 16 <= n; i += 16)
+		{
+			unsigned long long wa[2];
+			unsigned long long wb[2];
+			memcpy(wa, a + i, 16);
+			memcpy(wb, b + i, 16);
+			unsigned long long const x0 = wa[0] ^ wb[0];
+			unsigned long long const x1 = wa[1] ^ wb[1];
+			if ((x0 | x1) != 0)
+				return i + static_cast<size_t>(x0 != 0 ? cudlb::countr_zero(x0) : 64 + cudlb::countr_zero(x1)) / 8;
+		}
+		if (i + 8 <= n)
+		{
+			unsigned long long wa;
+			unsigned long long wb;
+			memcpy(&wa, a + i, 8);
+			memcpy(&wb, b + i, 8);
+			if (wa != wb) return i + static_cast<size_t>(cudlb::countr_zero(wa ^ wb)) / 8;
+			i += 8;
+		}
+		for (; i != n; ++i)
+			if (a[i] != b[i]) return i;
+		return n;
+	}
+
+	template<typename T>
+	__host__ __device__
+	bool lexicographical_compare_contiguous(T* first_a, T* last_a, T* first_b, T* last_b, cudlb::true_type)
+	{
+		size_t const na = static_cast<size_t>(last_a - first_a);
+		size_t const nb = static_cast<size_t>(last_b - first_b);
+		size_t const n = na < nb ? na : nb;
+		size_t const offset = cudlb::mismatch_bytes(reinterpret_cast<unsigned char const*>(first_a), reinterpret_cast<unsigned char const*>(first_b), n * sizeof(T));
+		if (offset == n * sizeof(T)) return na < nb;
+		// The elements before the one holding the differing byte are all equal, only this pair decides the order.
+		size_t const k = offset / sizeof(T);
+		return first_a[k] < first_b[k];
+	}
+
+	template<typename T>
+	__host__ __device__
+	bool lexicographical_compare_contiguous(T* first_a, T* last_a, T* first_b, T* last_b, cudlb::false_type)
 	{
 		for (; first_a != last_a && first_b != last_b; ++first_a, ++first_b)
 		{
@@ -79,6 +217,56 @@ namespace cudlb
 		return (first_a == last_a) && (first_b != last_b);
 	}
 
+	/**
+	*	Contiguous ranges of elements with a unique object representation compare their common prefix as bytes,
+	*	16 per step, and only the first pair of differing elements with operator<.
+	*/
+	template<typename Iterator>
+	__host__ __device__
+	bool lexicographical_compare(Iterator first_a, Iterator last_a, Iterator first_b, Iterator last_b, cudlb::contiguous_iterator_tag)
+	{
+		using value_type = typename cudlb::iterator_traits<Iterator>::value_type;
+		auto const a = cudlb::to_address(first_a);
+		auto const b = cudlb::to_address(first_b);
+		return cudlb::lexicographical_compare_contiguous(a, a + (last_a - first_a), b, b + (last_b - first_b), cudlb::has_unique_object_representation<value_type>());
+	}
+
+	/**
+	*	Checks if the first range provided is lexicographically LESS than the second. 
+	*	@[first_a : last_a) - first range of elements. 
+	*	@[first_b : last_b) - second range of elements. 
+	*	Returns true if first range is lexicographically LESS than the second. 
+	*	Returns false if the two ranges are lexicographically equal.
+	*	Returns false if the second range is LESS than the first. 
+	*/
+	template<typename Iterator>
+	__host__ __device__
+	bool lexicographical_compare(Iterator first_a, Iterator last_a, Iterator first_b, Iterator last_b)
+	{
+		return cudlb::lexicographical_compare(first_a, last_a, first_b, last_b, typename cudlb::iterator_traits<Iterator>::iterator_category());
+	}
+
+	/**
+	*	Contiguous ranges of elements with a unique object representation are compared as bytes, 16 per step.
+	*/
+	template<typename Iterator>
+	__host__ __device__
+	bool equal(Iterator first_a, Iterator last_a, Iterator first_b, Iterator last_b, cudlb::contiguous_iterator_tag)
+	{
+		using value_type = typename cudlb::iterator_traits<Iterator>::value_type;
+		if (last_a - first_a != last_b - first_b) return false;
+		auto const a = cudlb::to_address(first_a);
+		auto const b = cudlb::to_address(first_b);
+		size_t const n = static_cast<size_t>(last_a - first_a);
+		if (cudlb::has_unique_object_representation<value_type>::value)
+		{
+			size_t const bytes = n * sizeof(value_type);
+			return cudlb::mismatch_bytes(reinterpret_cast<unsigned char const*>(a), reinterpret_cast<unsigned char const*>(b), bytes) == bytes;
+		}
+		for (size_t i = 0; i != n; ++i)
+			if (a[i] != b[i]) return false;
+		return true;
+	}
 
 	/**
 	*	Checks if two ranges are equal, have equal number of elements and the elements match. 
@@ -86,35 +274,213 @@ namespace cudlb
 	*	@[first_b : last_b) - second range of elements.
 	*	Returns true if both ranges are equal. 
 	*/
-	template<typename Iterator> 
-	__host__ __device__ 
+	template<typename Iterator>
+	__host__ __device__
 	bool equal(Iterator first_a, Iterator last_a, Iterator first_b, Iterator last_b)
 	{
-		using iter = cudlb::iterator_traits<Iterator>;
+		return cudlb::equal(first_a, last_a, first_b, last_b, typename cudlb::iterator_traits<Iterator>::iterator_category());
+	}
 
-		if (iter::distance(first_a, last_a) == iter::distance(first_b, last_b))
-		{
-			for (; first_a != last_a && first_b != last_b; ++first_a, ++first_b)
-				if (*first_a != *first_b) return false; 
+	template<typename Iterator, typename T> 
+	__host__ __device__
+	Iterator find(Iterator first, Iterator last, T const& value, cudlb::input_iterator_tag)
+	{
+		for (; first != last; ++first)
+			if (*first == value) return first; 
+		return last; 
+	}
 
-			return true;
+	/**
+	*	Compares simd_block_bytes() of elements per step, used by cudlb::find for contiguous arithmetic ranges.
+	*	Elements before the first block boundary and after the last one are compared one at a time.
+	*/
+	template<typename T>
+	__host__ __device__
+	T* find_contiguous(T* first, T* last, T const value, cudlb::true_type)
+	{
+		constexpr size_t lanes = cudlb::simd_block_bytes() / sizeof(T);
+		for (; first != last && reinterpret_cast<uintptr_t>(first) % cudlb::simd_block_bytes() != 0; ++first)
+			if (*first == value) return first;
+		for (; static_cast<size_t>(last - first) >= lanes; first += lanes)
+		{
+			unsigned long long const mask = cudlb::match_block(first, value);
+			if (mask != 0) return first + cudlb::countr_zero(mask) / sizeof(T);
 		}
-		return false;
+		for (; first != last; ++first)
+			if (*first == value) return first;
+		return last;
+	}
+
+	template<typename T, typename U>
+	__host__ __device__
+	T* find_contiguous(T* first, T* last, U const& value, cudlb::false_type)
+	{
+		for (; first != last; ++first)
+			if (*first == value) return first;
+		return last;
+	}
+
+	/**
+	*	In a contiguous range of integers, float or double searched for a value of the same type,
+	*	a vector of elements is compared at a time, with SSE2 or AVX2 instructions in host builds
+	*	and one 128-bit load per block in device code.
+	*/
+	template<typename Iterator, typename U>
+	__host__ __device__
+	Iterator find(Iterator first, Iterator last, U const& value, cudlb::contiguous_iterator_tag)
+	{
+		using T = typename cudlb::remove_reference<decltype(*first)>::value_type;
+		using vectorized = cudlb::integral_constant<bool,
+			cudlb::is_same<typename cudlb::remove_cv<T>::value_type, U>::value && cudlb::simd_kind<U>::value != 0>;
+		T* const p = cudlb::to_address(first);
+		return first + (cudlb::find_contiguous<T>(p, p + (last - first), value, vectorized()) - p);
 	}
 
 	/**
 	*	Looks for an element with a given value in a range [first, last).
+	*	Contiguous ranges of arithmetic elements are searched a vector of elements at a time.
 	*	@[first : last) - range of elements to look for the element.
-	*	@val - element value to look for.
+	*	@value - element value to look for.
 	*	Returns an iterator to the element if found, otherwise returns last element in the range. 
 	*/
-	template<typename Iterator, typename T> 
+	template<typename Iterator, typename T>
 	__host__ __device__
 	Iterator find(Iterator first, Iterator last, T const& value)
+	{
+		return cudlb::find(first, last, value, typename cudlb::iterator_traits<Iterator>::iterator_category());
+	}
+
+	template<typename Iterator, typename Predicate>
+	__host__ __device__
+	Iterator find_if(Iterator first, Iterator last, Predicate pred, cudlb::input_iterator_tag)
 	{
 		for (; first != last; ++first)
-			if (*first == val) return first; 
-		return last; 
+			if (pred(*first)) return first;
+		return last;
+	}
+
+	/**
+	*	Contiguous integer and floating point ranges are tested 8 elements per step and the results gathered into a mask
+	*	without branching, which lets the compiler evaluate simple predicates on a whole vector of elements.
+	*/
+	template<typename Iterator, typename Predicate>
+	__host__ __device__
+	Iterator find_if(Iterator first, Iterator last, Predicate pred, cudlb::contiguous_iterator_tag)
+	{
+		using T = typename cudlb::remove_reference<decltype(*first)>::value_type;
+		T* const begin = cudlb::to_address(first);
+		T* const end = begin + (last - first);
+		T* p = begin;
+		if (cudlb::simd_kind<T>::value != 0)
+		{
+			for (; end - p >= 8; p += 8)
+			{
+				unsigned int mask = 0;
+				for (int i = 0; i != 8; ++i)
+					mask |= static_cast<unsigned int>(static_cast<bool>(pred(p[i]))) << i;
+				if (mask != 0) return first + ((p - begin) + cudlb::countr_zero(mask));
+			}
+		}
+		for (; p != end; ++p)
+			if (pred(*p)) return first + (p - begin);
+		return last;
+	}
+
+	/**
+	*	Looks for the first element of a range [first, last) satisfying a predicate.
+	*	@[first : last) - range of elements to look for the element.
+	*	@pred - unary predicate.
+	*	Returns an iterator to the first element for which @pred returns true, otherwise last.
+	*	NOTE: For a contiguous range @pred may be called for up to 7 elements past the one returned,
+	*	it must not have side effects.
+	*/
+	template<typename Iterator, typename Predicate>
+	__host__ __device__
+	Iterator find_if(Iterator first, Iterator last, Predicate pred)
+	{
+		return cudlb::find_if(first, last, pred, typename cudlb::iterator_traits<Iterator>::iterator_category());
+	}
+
+	template<typename Iterator, typename T>
+	__host__ __device__
+	size_t count(Iterator first, Iterator last, T const& value, cudlb::input_iterator_tag)
+	{
+		size_t n = 0;
+		for (; first != last; ++first)
+			n += static_cast<size_t>(*first == value);
+		return n;
+	}
+
+	/**
+	*	Compares simd_block_bytes() of elements per step, used by cudlb::count for contiguous arithmetic ranges.
+	*/
+	template<typename T>
+	__host__ __device__
+	size_t count_contiguous(T const* first, T const* last, T const value, cudlb::true_type)
+	{
+		constexpr size_t lanes = cudlb::simd_block_bytes() / sizeof(T);
+		size_t n = 0;
+		for (; first != last && reinterpret_cast<uintptr_t>(first) % cudlb::simd_block_bytes() != 0; ++first)
+			n += static_cast<size_t>(*first == value);
+		for (; static_cast<size_t>(last - first) >= lanes; first += lanes)
+			n += static_cast<size_t>(cudlb::popcount(cudlb::match_block(first, value) & cudlb::simd_lane_mask<T>()));
+		for (; first != last; ++first)
+			n += static_cast<size_t>(*first == value);
+		return n;
+	}
+
+	template<typename T, typename U>
+	__host__ __device__
+	size_t count_contiguous(T const* first, T const* last, U const& value, cudlb::false_type)
+	{
+		size_t n = 0;
+		for (; first != last; ++first)
+			n += static_cast<size_t>(*first == value);
+		return n;
+	}
+
+	/**
+	*	Contiguous ranges are vectorized like in cudlb::find, the matches of a block are counted with one popcount.
+	*/
+	template<typename Iterator, typename U>
+	__host__ __device__
+	size_t count(Iterator first, Iterator last, U const& value, cudlb::contiguous_iterator_tag)
+	{
+		using T = typename cudlb::remove_reference<decltype(*first)>::value_type;
+		using vectorized = cudlb::integral_constant<bool,
+			cudlb::is_same<typename cudlb::remove_cv<T>::value_type, U>::value && cudlb::simd_kind<U>::value != 0>;
+		T* const p = cudlb::to_address(first);
+		return cudlb::count_contiguous<typename cudlb::remove_cv<T>::value_type>(p, p + (last - first), value, vectorized());
+	}
+
+	/**
+	*	Counts the elements of a range [first, last) equal to a value.
+	*	Contiguous ranges of arithmetic elements are counted a vector of elements at a time.
+	*	@[first : last) - range of elements to count.
+	*	@value - element value to count.
+	*/
+	template<typename Iterator, typename T>
+	__host__ __device__
+	size_t count(Iterator first, Iterator last, T const& value)
+	{
+		return cudlb::count(first, last, value, typename cudlb::iterator_traits<Iterator>::iterator_category());
+	}
+
+	/**
+	*	Counts the elements of a range [first, last) satisfying a predicate.
+	*	The count is accumulated without branching on the predicate, so that simple predicates over
+	*	contiguous ranges are vectorized by the compiler.
+	*	@[first : last) - range of elements to count.
+	*	@pred - unary predicate.
+	*/
+	template<typename Iterator, typename Predicate>
+	__host__ __device__
+	size_t count_if(Iterator first, Iterator last, Predicate pred)
+	{
+		size_t n = 0;
+		for (; first != last; ++first)
+			n += static_cast<size_t>(static_cast<bool>(pred(*first)));
+		return n;
 	}
 
 	/**
@@ -131,9 +497,10 @@ namespace cudlb
 	}
 
 	/**
-	*	Tony Hoare's partitioning algorithm, used by cudlb::sort.
+	*	Tony Hoare's partitioning algorithm around the value of the first element, which is moved to its sorted position.
 	*	@first - first element of range to partition. 
-	*	@second - last element of range to partition. 
+	*	@last - end of range to partition. 
+	*	Returns an iterator to the pivot, no element before it is greater and no element after it is less or equal.
 	*/
 	template<typename Iterator> 
 	__host__ __device__ 
@@ -146,7 +513,7 @@ namespace cudlb
 		while(i <= j)
 		{
 			while (i <= j && *i <= pivot) ++i;
-			while (i <= j && *i > pivot) --j; 
+			while (i <= j && *j > pivot) --j; 
 			if (i < j) cudlb::iter_swap(i, j);
 		}
 		cudlb::iter_swap(i - 1, first);
@@ -154,19 +521,1848 @@ namespace cudlb
 	}
 
 	/**
-	*	Partitions the range into smaller ones and sorts the values. 
-	*	@first - first element of range to sort.
-	*	@second - last element of range to sort.
+	*	Prefetches the element an iterator refers to, only done for pointers into contiguous memory.
 	*/
-	template<typename Iterator> 
+	template<typename T>
+	__host__ __device__
+	void prefetch_element(T* p)
+	{
+		cudlb::prefetch(p);
+	}
+
+	template<typename Iterator>
+	__host__ __device__
+	void prefetch_element(Iterator const&) {}
+
+	/**
+	*	Binary search of a forward range, such as the elements of a node based container:
+	*	O(log n) comparisons, but the iterator is advanced one element at a time. The start is advanced in place,
+	*	never assigned, so iterators holding a lambda, which cannot be assigned, are searched as well.
+	*/
+	template<typename Iterator, typename T, typename Compare>
+	__host__ __device__
+	Iterator lower_bound(Iterator first, Iterator last, T const& value, Compare comp, cudlb::forward_iterator_tag)
+	{
+		auto n = cudlb::distance(first, last);
+		while (n > 0)
+		{
+			auto const half = n / 2;
+			Iterator const mid = cudlb::next(first, half);
+			if (comp(*mid, value))
+			{
+				cudlb::advance(first, half + 1);
+				n -= half + 1;
+			}
+			else n = half;
+		}
+		return first;
+	}
+
+	/**
+	*	The search of a random access range halves it without branching on the comparison, the new start is selected
+	*	with a conditional move, so all searches over a range of the same length take the same number of steps
+	*	and threads of a warp never diverge. Both midpoints of the next step are prefetched.
+	*/
+	template<typename Iterator, typename T, typename Compare>
+	__host__ __device__
+	Iterator lower_bound(Iterator first, Iterator last, T const& value, Compare comp, cudlb::random_access_iterator_tag)
+	{
+		auto n = last - first;
+		if (n == 0) return last;
+		while (n > 1)
+		{
+			auto const half = n / 2;
+			n -= half;
+			cudlb::prefetch_element(first + n / 2);
+			cudlb::prefetch_element(first + half + n / 2);
+			first = comp(first[half], value) ? first + half : first;
+		}
+		return comp(*first, value) ? first + 1 : first;
+	}
+
+	/**
+	*	Finds the first element in a sorted range which is NOT LESS than a value.
+	*	Random access ranges are searched branch free, forward ranges with an ordinary binary search.
+	*	@[first : last) - forward range sorted with respect to @comp.
+	*	@value - value to compare the elements to.
+	*	@comp - comparator, true if the first argument is ordered before the second.
+	*	Returns an iterator to the first element not ordered before @value, or last if there is none.
+	*/
+	template<typename Iterator, typename T, typename Compare>
+	__host__ __device__
+	Iterator lower_bound(Iterator first, Iterator last, T const& value, Compare comp)
+	{
+		return cudlb::lower_bound(first, last, value, comp, typename cudlb::iterator_traits<Iterator>::iterator_category());
+	}
+
+	template<typename Iterator, typename T>
+	__host__ __device__
+	Iterator lower_bound(Iterator first, Iterator last, T const& value)
+	{
+		return cudlb::lower_bound(first, last, value, cudlb::less<T>());
+	}
+
+	template<typename Iterator, typename T, typename Compare>
+	__host__ __device__
+	Iterator upper_bound(Iterator first, Iterator last, T const& value, Compare comp, cudlb::forward_iterator_tag)
+	{
+		auto n = cudlb::distance(first, last);
+		while (n > 0)
+		{
+			auto const half = n / 2;
+			Iterator const mid = cudlb::next(first, half);
+			if (!comp(value, *mid))
+			{
+				cudlb::advance(first, half + 1);
+				n -= half + 1;
+			}
+			else n = half;
+		}
+		return first;
+	}
+
+	template<typename Iterator, typename T, typename Compare>
 	__host__ __device__
-	void sort(Iterator first, Iterator second)
+	Iterator upper_bound(Iterator first, Iterator last, T const& value, Compare comp, cudlb::random_access_iterator_tag)
 	{
-		if (first < last)
+		auto n = last - first;
+		if (n == 0) return last;
+		while (n > 1)
 		{
-			auto p = cudlb::partition(first, last);
-			sort(first, p);
-			sort(p + 1, last);
+			auto const half = n / 2;
+			n -= half;
+			cudlb::prefetch_element(first + n / 2);
+			cudlb::prefetch_element(first + half + n / 2);
+			first = comp(value, first[half]) ? first : first + half;
 		}
+		return comp(value, *first) ? first : first + 1;
+	}
+
+	/**
+	*	Finds the first element in a sorted range which is GREATER than a value, searched like by cudlb::lower_bound.
+	*	@[first : last) - forward range sorted with respect to @comp.
+	*	@value - value to compare the elements to.
+	*	@comp - comparator, true if the first argument is ordered before the second.
+	*	Returns an iterator to the first element @value is ordered before, or last if there is none.
+	*/
+	template<typename Iterator, typename T, typename Compare>
+	__host__ __device__
+	Iterator upper_bound(Iterator first, Iterator last, T const& value, Compare comp)
+	{
+		return cudlb::upper_bound(first, last, value, comp, typename cudlb::iterator_traits<Iterator>::iterator_category());
+	}
+
+	template<typename Iterator, typename T>
+	__host__ __device__
+	Iterator upper_bound(Iterator first, Iterator last, T const& value)
+	{
+		return cudlb::upper_bound(first, last, value, cudlb::less<T>());
+	}
+
+	/**
+	*	Checks if a sorted range holds an element equivalent to a value.
+	*	@[first : last) - forward range sorted with respect to @comp.
+	*	@value - value to look for.
+	*	@comp - comparator, true if the first argument is ordered before the second.
+	*/
+	template<typename Iterator, typename T, typename Compare>
+	__host__ __device__
+	bool binary_search(Iterator first, Iterator last, T const& value, Compare comp)
+	{
+		first = cudlb::lower_bound(first, last, value, comp);
+		return first != last && !comp(value, *first);
+	}
+
+	template<typename Iterator, typename T>
+	__host__ __device__
+	bool binary_search(Iterator first, Iterator last, T const& value)
+	{
+		return cudlb::binary_search(first, last, value, cudlb::less<T>());
+	}
+
+	/**
+	*	Finds the range of elements in a sorted range which are equivalent to a value.
+	*	@[first : last) - forward range sorted with respect to @comp.
+	*	@value - value to look for.
+	*	@comp - comparator, true if the first argument is ordered before the second.
+	*	Returns the pair of cudlb::lower_bound and cudlb::upper_bound, the upper bound is searched for after the lower one.
+	*/
+	template<typename Iterator, typename T, typename Compare>
+	__host__ __device__
+	cudlb::pair<Iterator, Iterator> equal_range(Iterator first, Iterator last, T const& value, Compare comp)
+	{
+		Iterator const lower = cudlb::lower_bound(first, last, value, comp);
+		return cudlb::pair<Iterator, Iterator>{ lower, cudlb::upper_bound(lower, last, value, comp) };
+	}
+
+	template<typename Iterator, typename T>
+	__host__ __device__
+	cudlb::pair<Iterator, Iterator> equal_range(Iterator first, Iterator last, T const& value)
+	{
+		return cudlb::equal_range(first, last, value, cudlb::less<T>());
+	}
+
+	/**
+	*	Runs cudlb::lower_bound for every value of a range, writing one iterator per value.
+	*	Searches are run in groups of 16 which step through the levels of the search together,
+	*	so the memory accesses of one level of all searches in a group are in flight at the same time
+	*	instead of waiting for one search to finish before the next one starts.
+	*	@[first : last) - random access range sorted with respect to @comp.
+	*	@[values_first : values_last) - values to search for, read once per level so a forward iterator is required.
+	*	@out - iterator to the first of (values_last - values_first) results.
+	*	@comp - comparator, true if the first argument is ordered before the second.
+	*	Returns an iterator past the last result written.
+	*/
+	template<typename Iterator, typename ValueIterator, typename OutputIterator, typename Compare>
+	__host__ __device__
+	OutputIterator lower_bound_batch(Iterator first, Iterator last, ValueIterator values_first, ValueIterator values_last, OutputIterator out, Compare comp)
+	{
+		constexpr int group_size = 16;
+		auto const size = last - first;
+		Iterator base[group_size];
+		while (values_first != values_last)
+		{
+			ValueIterator const group_first = values_first;
+			int g = 0;
+			for (; g != group_size && values_first != values_last; ++g, ++values_first)
+				base[g] = first;
+
+			if (size == 0)
+			{
+				for (int i = 0; i != g; ++i, ++out)
+					*out = last;
+				continue;
+			}
+
+			auto n = size;
+			while (n > 1)
+			{
+				auto const half = n / 2;
+				n -= half;
+				ValueIterator v = group_first;
+				for (int i = 0; i != g; ++i, ++v)
+				{
+					cudlb::prefetch_element(base[i] + n / 2);
+					cudlb::prefetch_element(base[i] + half + n / 2);
+					base[i] = comp(base[i][half], *v) ? base[i] + half : base[i];
+				}
+			}
+			ValueIterator v = group_first;
+			for (int i = 0; i != g; ++i, ++v, ++out)
+				*out = comp(*base[i], *v) ? base[i] + 1 : base[i];
+		}
+		return out;
+	}
+
+	template<typename Iterator, typename ValueIterator, typename OutputIterator>
+	__host__ __device__
+	OutputIterator lower_bound_batch(Iterator first, Iterator last, ValueIterator values_first, ValueIterator values_last, OutputIterator out)
+	{
+		using value_type = typename cudlb::remove_reference<decltype(*values_first)>::value_type;
+		return cudlb::lower_bound_batch(first, last, values_first, values_last, out, cudlb::less<value_type>());
+	}
+
+	/**
+	*	Copies the elements of a range which satisfy a predicate, keeping their order.
+	*	@[first : last) - range of elements.
+	*	@out - start of the output range.
+	*	@pred - unary predicate.
+	*	Returns an iterator past the last element copied.
+	*/
+	template<typename InputIterator, typename OutputIterator, typename Predicate>
+	__host__ __device__
+	OutputIterator copy_if(InputIterator first, InputIterator last, OutputIterator out, Predicate pred)
+	{
+		for (; first != last; ++first)
+		{
+			if (pred(*first))
+			{
+				*out = *first;
+				++out;
+			}
+		}
+		return out;
+	}
+
+	/**
+	*	Copies the elements of a range to one of two outputs, depending on a predicate, keeping their order.
+	*	@[first : last) - range of elements.
+	*	@out_true - start of the output range of the elements satisfying @pred.
+	*	@out_false - start of the output range of the other elements.
+	*	@pred - unary predicate.
+	*	Returns the iterators past the last element copied to each output.
+	*/
+	template<typename InputIterator, typename OutputTrue, typename OutputFalse, typename Predicate>
+	__host__ __device__
+	cudlb::pair<OutputTrue, OutputFalse> partition_copy(InputIterator first, InputIterator last, OutputTrue out_true, OutputFalse out_false, Predicate pred)
+	{
+		for (; first != last; ++first)
+		{
+			if (pred(*first))
+			{
+				*out_true = *first;
+				++out_true;
+			}
+			else
+			{
+				*out_false = *first;
+				++out_false;
+			}
+		}
+		return cudlb::pair<OutputTrue, OutputFalse>{ out_true, out_false };
+	}
+
+	/**
+	*	Counts the elements satisfying a predicate in every tile of a range and scans the counts,
+	*	giving the offset at which every tile writes its first selected element.
+	*	@offsets - receives tiles.tiles + 1 offsets, the last one is the total count.
+	*	NOTE: Shared by the parallel stream compaction algorithms.
+	*/
+	template<typename Iterator, typename Predicate>
+	__host__ __device__
+	void tile_offsets(Iterator first, cudlb::tiling const& tiles, Predicate pred, cudlb::tile_buffer<size_t>& offsets)
+	{
+		cudlb::parallel_for(tiles.tiles, [&](size_t const t) {
+			offsets.construct(t + 1, cudlb::count_if(first + tiles.begin(t), first + tiles.end(t), pred));
+		});
+		offsets.construct(0, size_t(0));
+		for (size_t t = 1; t <= tiles.tiles; ++t)
+			offsets[t] += offsets[t - 1];
+	}
+
+	/**
+	*	Parallel cudlb::copy_if over random access ranges.
+	*	Every tile counts its selected elements, the counts are scanned into output offsets
+	*	and every tile then copies its elements to its own part of the output, so the order is kept without atomics.
+	*	NOTE: @pred is called twice per element and must not have side effects.
+	*/
+	template<typename InputIterator, typename OutputIterator, typename Predicate>
+	__host__ __device__
+	OutputIterator tiled_copy_if(InputIterator first, InputIterator last, OutputIterator out, Predicate pred, cudlb::true_type)
+	{
+		cudlb::tiling const tiles = cudlb::make_tiling(static_cast<size_t>(last - first));
+		if (tiles.tiles == 1) return cudlb::copy_if(first, last, out, pred);
+
+		cudlb::tile_buffer<size_t> offsets{ tiles.tiles + 1 };
+		cudlb::tile_offsets(first, tiles, pred, offsets);
+		cudlb::parallel_for(tiles.tiles, [&](size_t const t) {
+			cudlb::copy_if(first + tiles.begin(t), first + tiles.end(t), out + offsets[t], pred);
+		});
+		return out + offsets[tiles.tiles];
+	}
+
+	template<typename InputIterator, typename OutputIterator, typename Predicate>
+	__host__ __device__
+	OutputIterator tiled_copy_if(InputIterator first, InputIterator last, OutputIterator out, Predicate pred, cudlb::false_type)
+	{
+		return cudlb::copy_if(first, last, out, pred);
+	}
+
+	template<typename InputIterator, typename OutputIterator, typename Predicate>
+	__host__ __device__
+	OutputIterator copy_if(cudlb::parallel_policy, InputIterator first, InputIterator last, OutputIterator out, Predicate pred)
+	{
+		return cudlb::tiled_copy_if(first, last, out, pred, cudlb::parallel_iterators<InputIterator, OutputIterator>());
+	}
+
+	/**
+	*	Parallel cudlb::partition_copy over random access ranges, tiled like the parallel copy_if.
+	*	A tile's first element satisfying @pred goes to the count of such elements in the tiles before it,
+	*	its first other element to the tile's start minus that count.
+	*	NOTE: @pred is called twice per element and must not have side effects.
+	*/
+	template<typename InputIterator, typename OutputTrue, typename OutputFalse, typename Predicate>
+	__host__ __device__
+	cudlb::pair<OutputTrue, OutputFalse> tiled_partition_copy(InputIterator first, InputIterator last, OutputTrue out_true, OutputFalse out_false, Predicate pred, cudlb::true_type)
+	{
+		size_t const n = static_cast<size_t>(last - first);
+		cudlb::tiling const tiles = cudlb::make_tiling(n);
+		if (tiles.tiles == 1) return cudlb::partition_copy(first, last, out_true, out_false, pred);
+
+		cudlb::tile_buffer<size_t> offsets{ tiles.tiles + 1 };
+		cudlb::tile_offsets(first, tiles, pred, offsets);
+		cudlb::parallel_for(tiles.tiles, [&](size_t const t) {
+			cudlb::partition_copy(first + tiles.begin(t), first + tiles.end(t),
+				out_true + offsets[t], out_false + (tiles.begin(t) - offsets[t]), pred);
+		});
+		size_t const selected = offsets[tiles.tiles];
+		return cudlb::pair<OutputTrue, OutputFalse>{ out_true + selected, out_false + (n - selected) };
+	}
+
+	template<typename InputIterator, typename OutputTrue, typename OutputFalse, typename Predicate>
+	__host__ __device__
+	cudlb::pair<OutputTrue, OutputFalse> tiled_partition_copy(InputIterator first, InputIterator last, OutputTrue out_true, OutputFalse out_false, Predicate pred, cudlb::false_type)
+	{
+		return cudlb::partition_copy(first, last, out_true, out_false, pred);
+	}
+
+	template<typename InputIterator, typename OutputTrue, typename OutputFalse, typename Predicate>
+	__host__ __device__
+	cudlb::pair<OutputTrue, OutputFalse> partition_copy(cudlb::parallel_policy, InputIterator first, InputIterator last, OutputTrue out_true, OutputFalse out_false, Predicate pred)
+	{
+		return cudlb::tiled_partition_copy(first, last, out_true, out_false, pred, cudlb::parallel_iterators<InputIterator, OutputTrue, OutputFalse>());
+	}
+
+	/**
+	*	Stable partition through a buffer, with the given tiling.
+	*	The elements are moved into a buffer of the size of the range, those satisfying @pred first, and moved back.
+	*/
+	template<typename Iterator, typename Predicate>
+	__host__ __device__
+	Iterator tiled_stable_partition(Iterator first, Iterator last, Predicate pred, cudlb::tiling const& tiles)
+	{
+		using value_type = typename cudlb::remove_cv<typename cudlb::remove_reference<decltype(*first)>::value_type>::value_type;
+		size_t const n = static_cast<size_t>(last - first);
+		if (n == 0) return first;
+
+		cudlb::tile_buffer<size_t> offsets{ tiles.tiles + 1 };
+		cudlb::tile_offsets(first, tiles, pred, offsets);
+		size_t const selected = offsets[tiles.tiles];
+
+		cudlb::tile_buffer<value_type> buffer{ n };
+		cudlb::parallel_for(tiles.tiles, [&](size_t const t) {
+			size_t to_true = offsets[t];
+			size_t to_false = selected + tiles.begin(t) - offsets[t];
+			for (Iterator it = first + tiles.begin(t); it != first + tiles.end(t); ++it)
+			{
+				if (pred(*it)) buffer.construct(to_true++, static_cast<value_type&&>(*it));
+				else buffer.construct(to_false++, static_cast<value_type&&>(*it));
+			}
+		});
+		cudlb::parallel_for(tiles.tiles, [&](size_t const t) {
+			for (size_t i = tiles.begin(t); i != tiles.end(t); ++i)
+				first[i] = static_cast<value_type&&>(buffer[i]);
+		});
+		return first + selected;
+	}
+
+	/**
+	*	Reorders a range so that the elements satisfying a predicate come before the others,
+	*	keeping the relative order within both groups.
+	*	@[first : last) - random access range of elements.
+	*	@pred - unary predicate.
+	*	Returns an iterator to the first element not satisfying @pred.
+	*	NOTE: Uses a buffer as large as the range, @pred is called twice per element and must not have side effects.
+	*/
+	template<typename Iterator, typename Predicate>
+	__host__ __device__
+	Iterator stable_partition(Iterator first, Iterator last, Predicate pred)
+	{
+		return cudlb::tiled_stable_partition(first, last, pred, cudlb::tiling{ static_cast<size_t>(last - first), 1 });
+	}
+
+	/**
+	*	Parallel cudlb::stable_partition, every tile scatters its elements to the buffer positions given by the
+	*	scanned tile counts and moves back its own part of the buffer.
+	*/
+	template<typename Iterator, typename Predicate>
+	__host__ __device__
+	Iterator stable_partition(cudlb::parallel_policy, Iterator first, Iterator last, Predicate pred)
+	{
+		return cudlb::tiled_stable_partition(first, last, pred, cudlb::make_tiling(static_cast<size_t>(last - first)));
+	}
+
+	/**
+	*	Reverses the order of the elements of a range.
+	*	@[first : last) - bidirectional range of elements.
+	*/
+	template<typename Iterator>
+	__host__ __device__
+	void reverse(Iterator first, Iterator last)
+	{
+		for (; first != last && first != --last; ++first)
+			cudlb::iter_swap(first, last);
+	}
+
+	/**
+	*	Rotates a range so that @middle becomes its first element, by three reversals.
+	*	@[first : last) - bidirectional range of elements.
+	*	@middle - element to move to the front.
+	*	Returns an iterator to the new position of the element at @first.
+	*/
+	template<typename Iterator>
+	__host__ __device__
+	Iterator rotate(Iterator first, Iterator middle, Iterator last)
+	{
+		if (first == middle) return last;
+		if (middle == last) return first;
+		cudlb::reverse(first, middle);
+		cudlb::reverse(middle, last);
+		auto const tail = cudlb::distance(middle, last);
+		cudlb::reverse(first, last);
+		return cudlb::next(first, tail);
+	}
+
+	/**
+	*	Merges two sorted ranges into one sorted output range.
+	*	The merge is stable, of equivalent elements those of the first range come first.
+	*	@[first_a : last_a) - first sorted range.
+	*	@[first_b : last_b) - second sorted range.
+	*	@out - start of the output range, which must not overlap the inputs.
+	*	@comp - comparator, true if the first argument is ordered before the second.
+	*	Returns an iterator past the last element written.
+	*/
+	template<typename IteratorA, typename IteratorB, typename OutputIterator, typename Compare>
+	__host__ __device__
+	OutputIterator merge(IteratorA first_a, IteratorA last_a, IteratorB first_b, IteratorB last_b, OutputIterator out, Compare comp)
+	{
+		for (; first_a != last_a && first_b != last_b; ++out)
+		{
+			if (comp(*first_b, *first_a)) { *out = *first_b; ++first_b; }
+			else { *out = *first_a; ++first_a; }
+		}
+		out = cudlb::copy(first_a, last_a, out);
+		return cudlb::copy(first_b, last_b, out);
+	}
+
+	template<typename IteratorA, typename IteratorB, typename OutputIterator>
+	__host__ __device__
+	OutputIterator merge(IteratorA first_a, IteratorA last_a, IteratorB first_b, IteratorB last_b, OutputIterator out)
+	{
+		using value_type = typename cudlb::remove_cv<typename cudlb::remove_reference<decltype(*first_a)>::value_type>::value_type;
+		return cudlb::merge(first_a, last_a, first_b, last_b, out, cudlb::less<value_type>());
+	}
+
+	/**
+	*	Stable merge which moves the elements instead of copying them, used by inplace_merge and stable_sort.
+	*/
+	template<typename IteratorA, typename IteratorB, typename OutputIterator, typename Compare>
+	__host__ __device__
+	OutputIterator move_merge(IteratorA first_a, IteratorA last_a, IteratorB first_b, IteratorB last_b, OutputIterator out, Compare comp)
+	{
+		using value_type = typename cudlb::remove_cv<typename cudlb::remove_reference<decltype(*first_a)>::value_type>::value_type;
+		for (; first_a != last_a && first_b != last_b; ++out)
+		{
+			if (comp(*first_b, *first_a)) { *out = static_cast<value_type&&>(*first_b); ++first_b; }
+			else { *out = static_cast<value_type&&>(*first_a); ++first_a; }
+		}
+		for (; first_a != last_a; ++first_a, ++out)
+			*out = static_cast<value_type&&>(*first_a);
+		for (; first_b != last_b; ++first_b, ++out)
+			*out = static_cast<value_type&&>(*first_b);
+		return out;
+	}
+
+	/**
+	*	Returns how many elements of the first range come before position @diagonal of the stable merge of two sorted ranges.
+	*	This is the merge path search, a binary search along the cross diagonal of the merge matrix.
+	*	@a - first sorted range, of @na elements.
+	*	@b - second sorted range, of @nb elements.
+	*	@diagonal - position in the merged output, at most na + nb.
+	*/
+	template<typename IteratorA, typename IteratorB, typename Compare>
+	__host__ __device__
+	size_t merge_path(IteratorA a, size_t const na, IteratorB b, size_t const nb, size_t const diagonal, Compare comp)
+	{
+		size_t lo = diagonal > nb ? diagonal - nb : 0;
+		size_t hi = diagonal < na ? diagonal : na;
+		while (lo < hi)
+		{
+			size_t const mid = lo + (hi - lo) / 2;
+			// a[mid] is before the diagonal if the element of b it competes with does not precede it.
+			if (!comp(b[diagonal - mid - 1], a[mid])) lo = mid + 1;
+			else hi = mid;
+		}
+		return lo;
+	}
+
+	/**
+	*	Parallel merge of two sorted random access ranges, each tile writes an equal slice of the output.
+	*	@move - true to move the elements instead of copying them.
+	*/
+	template<typename IteratorA, typename IteratorB, typename OutputIterator, typename Compare>
+	__host__ __device__
+	OutputIterator tiled_merge(IteratorA first_a, IteratorA last_a, IteratorB first_b, IteratorB last_b, OutputIterator out, Compare comp, bool const move)
+	{
+		size_t const na = static_cast<size_t>(last_a - first_a);
+		size_t const nb = static_cast<size_t>(last_b - first_b);
+		cudlb::tiling const tiles = cudlb::make_tiling(na + nb);
+		cudlb::parallel_for(tiles.tiles, [&](size_t const t) {
+			size_t const d0 = tiles.begin(t);
+			size_t const d1 = tiles.end(t);
+			size_t const i0 = cudlb::merge_path(first_a, na, first_b, nb, d0, comp);
+			size_t const i1 = cudlb::merge_path(first_a, na, first_b, nb, d1, comp);
+			if (move) cudlb::move_merge(first_a + i0, first_a + i1, first_b + (d0 - i0), first_b + (d1 - i1), out + d0, comp);
+			else cudlb::merge(first_a + i0, first_a + i1, first_b + (d0 - i0), first_b + (d1 - i1), out + d0, comp);
+		});
+		return out + (na + nb);
+	}
+
+	template<typename IteratorA, typename IteratorB, typename OutputIterator, typename Compare>
+	__host__ __device__
+	OutputIterator tiled_merge(IteratorA first_a, IteratorA last_a, IteratorB first_b, IteratorB last_b, OutputIterator out, Compare comp, cudlb::true_type)
+	{
+		return cudlb::tiled_merge(first_a, last_a, first_b, last_b, out, comp, false);
+	}
+
+	template<typename IteratorA, typename IteratorB, typename OutputIterator, typename Compare>
+	__host__ __device__
+	OutputIterator tiled_merge(IteratorA first_a, IteratorA last_a, IteratorB first_b, IteratorB last_b, OutputIterator out, Compare comp, cudlb::false_type)
+	{
+		return cudlb::merge(first_a, last_a, first_b, last_b, out, comp);
+	}
+
+	/**
+	*	Parallel cudlb::merge over random access ranges.
+	*	The output is split into equal slices, the merge path search finds where each slice starts in both inputs,
+	*	so every tile merges an independent part and the work is balanced whatever the distribution of the inputs.
+	*/
+	template<typename IteratorA, typename IteratorB, typename OutputIterator, typename Compare>
+	__host__ __device__
+	OutputIterator merge(cudlb::parallel_policy, IteratorA first_a, IteratorA last_a, IteratorB first_b, IteratorB last_b, OutputIterator out, Compare comp)
+	{
+		return cudlb::tiled_merge(first_a, last_a, first_b, last_b, out, comp, cudlb::parallel_iterators<IteratorA, IteratorB, OutputIterator>());
+	}
+
+	template<typename IteratorA, typename IteratorB, typename OutputIterator>
+	__host__ __device__
+	OutputIterator merge(cudlb::parallel_policy policy, IteratorA first_a, IteratorA last_a, IteratorB first_b, IteratorB last_b, OutputIterator out)
+	{
+		using value_type = typename cudlb::remove_cv<typename cudlb::remove_reference<decltype(*first_a)>::value_type>::value_type;
+		return cudlb::merge(policy, first_a, last_a, first_b, last_b, out, cudlb::less<value_type>());
+	}
+
+	/**
+	*	Merges two consecutive sorted ranges without a buffer, by rotating the second half of the first range
+	*	past the first half of the second range and recursing on both sides. Runs in O(n log n).
+	*/
+	template<typename Iterator, typename Compare>
+	__host__ __device__
+	void merge_without_buffer(Iterator first, Iterator middle, Iterator last, size_t const na, size_t const nb, Compare comp)
+	{
+		if (na == 0 || nb == 0) return;
+		if (na + nb == 2)
+		{
+			if (comp(*middle, *first)) cudlb::iter_swap(first, middle);
+			return;
+		}
+		Iterator cut_a;
+		Iterator cut_b;
+		if (na > nb)
+		{
+			cut_a = first + na / 2;
+			cut_b = cudlb::lower_bound(middle, last, *cut_a, comp);
+		}
+		else
+		{
+			cut_b = middle + nb / 2;
+			cut_a = cudlb::upper_bound(first, middle, *cut_b, comp);
+		}
+		size_t const na_left = static_cast<size_t>(cut_a - first);
+		size_t const nb_left = static_cast<size_t>(cut_b - middle);
+		Iterator const new_middle = cudlb::rotate(cut_a, middle, cut_b);
+		cudlb::merge_without_buffer(first, cut_a, new_middle, na_left, nb_left, comp);
+		cudlb::merge_without_buffer(new_middle, cut_b, last, na - na_left, nb - nb_left, comp);
+	}
+
+	/**
+	*	Merges two consecutive sorted ranges [first : middle) and [middle : last) into one sorted range.
+	*	The first range is moved to a buffer and merged back with the second one, if the buffer cannot be allocated
+	*	the merge falls back to merge_without_buffer.
+	*	@comp - comparator, true if the first argument is ordered before the second.
+	*/
+	template<typename Iterator, typename Compare>
+	__host__ __device__
+	void inplace_merge(Iterator first, Iterator middle, Iterator last, Compare comp)
+	{
+		using value_type = typename cudlb::remove_cv<typename cudlb::remove_reference<decltype(*first)>::value_type>::value_type;
+		size_t const na = static_cast<size_t>(middle - first);
+		size_t const nb = static_cast<size_t>(last - middle);
+		if (na == 0 || nb == 0) return;
+
+		cudlb::temporary_buffer<value_type> buffer{ na };
+		if (buffer.data() == nullptr)
+		{
+			cudlb::merge_without_buffer(first, middle, last, na, nb, comp);
+			return;
+		}
+		for (Iterator it = first; it != middle; ++it)
+			buffer.push_back(static_cast<value_type&&>(*it));
+		// The output never overtakes the unread part of the second range, it is written behind it.
+		cudlb::move_merge(buffer.data(), buffer.data() + na, middle, last, first, comp);
+	}
+
+	template<typename Iterator>
+	__host__ __device__
+	void inplace_merge(Iterator first, Iterator middle, Iterator last)
+	{
+		using value_type = typename cudlb::remove_cv<typename cudlb::remove_reference<decltype(*first)>::value_type>::value_type;
+		cudlb::inplace_merge(first, middle, last, cudlb::less<value_type>());
+	}
+
+	/**
+	*	Sorts short runs with insertion sort, the first pass of stable_sort.
+	*/
+	template<typename Iterator, typename Compare>
+	__host__ __device__
+	void insertion_sort(Iterator first, Iterator last, Compare comp)
+	{
+		using value_type = typename cudlb::remove_cv<typename cudlb::remove_reference<decltype(*first)>::value_type>::value_type;
+		if (first == last) return;
+		for (Iterator i = first + 1; i != last; ++i)
+		{
+			value_type v = static_cast<value_type&&>(*i);
+			Iterator j = i;
+			for (; j != first && comp(v, *(j - 1)); --j)
+				*j = static_cast<value_type&&>(*(j - 1));
+			*j = static_cast<value_type&&>(v);
+		}
+	}
+
+	/**
+	*	Sorts a random access range, keeping the order of equivalent elements.
+	*	Runs of 32 elements are sorted with insertion sort, then merged bottom up, alternating between the range
+	*	and a buffer of the same size.
+	*	@[first : last) - random access range of elements.
+	*	@comp - comparator, true if the first argument is ordered before the second.
+	*/
+	template<typename Iterator, typename Compare>
+	__host__ __device__
+	void stable_sort(Iterator first, Iterator last, Compare comp)
+	{
+		using value_type = typename cudlb::remove_cv<typename cudlb::remove_reference<decltype(*first)>::value_type>::value_type;
+		size_t const run = 32;
+		size_t const n = static_cast<size_t>(last - first);
+		for (size_t i = 0; i < n; i += run)
+			cudlb::insertion_sort(first + i, first + (n - i < run ? n : i + run), comp);
+		if (n <= run) return;
+
+		cudlb::temporary_buffer<value_type> buffer{ n };
+		if (buffer.data() == nullptr)
+		{
+			for (size_t width = run; width < n; width *= 2)
+			{
+				for (size_t i = 0; i + width < n; i += 2 * width)
+				{
+					size_t const end = n - i < 2 * width ? n : i + 2 * width;
+					cudlb::merge_without_buffer(first + i, first + (i + width), first + end, width, end - i - width, comp);
+				}
+			}
+			return;
+		}
+		for (size_t i = 0; i != n; ++i)
+			buffer.push_back(static_cast<value_type&&>(first[i]));
+
+		// Each pass merges pairs of runs from the buffer into the range or back, the runs start in the buffer.
+		value_type* const other = buffer.data();
+		bool in_buffer = true;
+		for (size_t width = run; width < n; width *= 2, in_buffer = !in_buffer)
+		{
+			for (size_t i = 0; i < n; i += 2 * width)
+			{
+				size_t const mid = n - i < width ? n : i + width;
+				size_t const end = n - i < 2 * width ? n : i + 2 * width;
+				if (in_buffer) cudlb::move_merge(other + i, other + mid, other + mid, other + end, first + i, comp);
+				else cudlb::move_merge(first + i, first + mid, first + mid, first + end, other + i, comp);
+			}
+		}
+		if (in_buffer)
+		{
+			for (size_t i = 0; i != n; ++i)
+				first[i] = static_cast<value_type&&>(other[i]);
+		}
+	}
+
+	template<typename Iterator>
+	__host__ __device__
+	void stable_sort(Iterator first, Iterator last)
+	{
+		using value_type = typename cudlb::remove_cv<typename cudlb::remove_reference<decltype(*first)>::value_type>::value_type;
+		cudlb::stable_sort(first, last, cudlb::less<value_type>());
+	}
+
+	/**
+	*	Parallel cudlb::stable_sort.
+	*	Every tile is sorted on its own, then the sorted tiles are merged pairwise with the parallel merge,
+	*	alternating between the range and a buffer of the same size.
+	*/
+	template<typename Iterator, typename Compare>
+	__host__ __device__
+	void stable_sort(cudlb::parallel_policy, Iterator first, Iterator last, Compare comp)
+	{
+		using value_type = typename cudlb::remove_cv<typename cudlb::remove_reference<decltype(*first)>::value_type>::value_type;
+		size_t const n = static_cast<size_t>(last - first);
+		cudlb::tiling const tiles = cudlb::make_tiling(n);
+		if (tiles.tiles == 1) return cudlb::stable_sort(first, last, comp);
+
+		cudlb::parallel_for(tiles.tiles, [&](size_t const t) {
+			cudlb::stable_sort(first + tiles.begin(t), first + tiles.end(t), comp);
+		});
+
+		cudlb::tile_buffer<value_type> buffer{ n };
+		cudlb::parallel_for(tiles.tiles, [&](size_t const t) {
+			for (size_t i = tiles.begin(t); i != tiles.end(t); ++i)
+				buffer.construct(i, static_cast<value_type&&>(first[i]));
+		});
+
+		value_type* const other = &buffer[0];
+		bool in_buffer = true;
+		for (size_t width = 1; width < tiles.tiles; width *= 2, in_buffer = !in_buffer)
+		{
+			for (size_t t = 0; t < tiles.tiles; t += 2 * width)
+			{
+				size_t const lo = tiles.begin(t);
+				size_t const mid = tiles.begin(t + width < tiles.tiles ? t + width : tiles.tiles);
+				size_t const hi = tiles.begin(t + 2 * width < tiles.tiles ? t + 2 * width : tiles.tiles);
+				if (in_buffer) cudlb::tiled_merge(other + lo, other + mid, other + mid, other + hi, first + lo, comp, true);
+				else cudlb::tiled_merge(first + lo, first + mid, first + mid, first + hi, other + lo, comp, true);
+			}
+		}
+		if (in_buffer)
+		{
+			cudlb::parallel_for(tiles.tiles, [&](size_t const t) {
+				for (size_t i = tiles.begin(t); i != tiles.end(t); ++i)
+					first[i] = static_cast<value_type&&>(other[i]);
+			});
+		}
+	}
+
+	template<typename Iterator>
+	__host__ __device__
+	void stable_sort(cudlb::parallel_policy policy, Iterator first, Iterator last)
+	{
+		using value_type = typename cudlb::remove_cv<typename cudlb::remove_reference<decltype(*first)>::value_type>::value_type;
+		cudlb::stable_sort(policy, first, last, cudlb::less<value_type>());
+	}
+
+	/**
+	*	Comparator ordering elements in the opposite direction of another one.
+	*/
+	template<typename Compare>
+	struct reverse_compare {
+		Compare comp;
+
+		template<typename T, typename U>
+		__host__ __device__
+		bool operator()(T const& lhs, U const& rhs) const
+		{
+			return comp(rhs, lhs);
+		}
+	};
+
+	/**
+	*	Moves the element at @hole of a heap of @n elements down to its place.
+	*	The heap has its greatest element, by @comp, at @first.
+	*/
+	template<typename Iterator, typename Compare>
+	__host__ __device__
+	void sift_down(Iterator first, size_t const n, size_t hole, Compare comp)
+	{
+		using value_type = typename cudlb::remove_cv<typename cudlb::remove_reference<decltype(*first)>::value_type>::value_type;
+		value_type v = static_cast<value_type&&>(first[hole]);
+		for (size_t child = 2 * hole + 1; child < n; child = 2 * hole + 1)
+		{
+			if (child + 1 < n && comp(first[child], first[child + 1])) ++child;
+			if (!comp(v, first[child])) break;
+			first[hole] = static_cast<value_type&&>(first[child]);
+			hole = child;
+		}
+		first[hole] = static_cast<value_type&&>(v);
+	}
+
+	/**
+	*	Arranges a random access range as a binary max heap, its greatest element by @comp first.
+	*/
+	template<typename Iterator, typename Compare>
+	__host__ __device__
+	void make_heap(Iterator first, Iterator last, Compare comp)
+	{
+		size_t const n = static_cast<size_t>(last - first);
+		for (size_t i = n / 2; i-- > 0;)
+			cudlb::sift_down(first, n, i, comp);
+	}
+
+	/**
+	*	Sorts a range arranged by cudlb::make_heap in ascending order.
+	*/
+	template<typename Iterator, typename Compare>
+	__host__ __device__
+	void sort_heap(Iterator first, Iterator last, Compare comp)
+	{
+		for (size_t n = static_cast<size_t>(last - first); n > 1; --n)
+		{
+			cudlb::iter_swap(first, first + (n - 1));
+			cudlb::sift_down(first, n - 1, 0, comp);
+		}
+	}
+
+	/**
+	*	Returns the median of three elements, the pivot of cudlb::nth_element.
+	*/
+	template<typename Iterator, typename Compare>
+	__host__ __device__
+	Iterator median_of_three(Iterator a, Iterator b, Iterator c, Compare comp)
+	{
+		if (comp(*a, *b))
+		{
+			if (comp(*b, *c)) return b;
+			return comp(*a, *c) ? c : a;
+		}
+		if (comp(*a, *c)) return a;
+		return comp(*b, *c) ? c : b;
+	}
+
+	/**
+	*	Partitions a range around the pivot at @first and moves the pivot to its sorted position, which is returned.
+	*	Elements equal to the pivot stop both scans, so ranges of equal elements are split in the middle.
+	*/
+	template<typename Iterator, typename Compare>
+	__host__ __device__
+	Iterator partition_pivot(Iterator first, Iterator last, Compare comp)
+	{
+		Iterator lo = first + 1;
+		Iterator hi = last - 1;
+		for (;;)
+		{
+			while (lo <= hi && comp(*lo, *first)) ++lo;
+			while (lo <= hi && comp(*first, *hi)) --hi;
+			if (lo >= hi) break;
+			cudlb::iter_swap(lo, hi);
+			++lo;
+			--hi;
+		}
+		cudlb::iter_swap(first, hi);
+		return hi;
+	}
+
+	template<typename Iterator, typename Compare>
+	__host__ __device__
+	void nth_element(Iterator first, Iterator nth, Iterator last, Compare comp);
+
+	/**
+	*	Returns a pivot by the median of medians of groups of 5, which is guaranteed to be
+	*	greater than and less than at least 30% of the range. The medians are gathered at the front of the range.
+	*/
+	template<typename Iterator, typename Compare>
+	__host__ __device__
+	Iterator median_of_medians(Iterator first, Iterator last, Compare comp)
+	{
+		size_t const groups = static_cast<size_t>(last - first) / 5;
+		for (size_t g = 0; g != groups; ++g)
+		{
+			Iterator const group = first + 5 * g;
+			cudlb::insertion_sort(group, group + 5, comp);
+			cudlb::iter_swap(first + g, group + 2);
+		}
+		cudlb::nth_element(first, first + groups / 2, first + groups, comp);
+		return first + groups / 2;
+	}
+
+	/**
+	*	Reorders a range so that @nth holds the element which would be there if the range were sorted,
+	*	no element before it is greater and no element after it is less.
+	*	Introselect, quickselect with median of three pivots which switches to median of medians pivots after
+	*	4 unbalanced partitions, those keeping more than 7/8 of the range. Every other round shrinks the range by
+	*	at least 1/8, so the rounds sum up to a constant times n and the worst case stays linear.
+	*	@[first : last) - random access range of elements.
+	*	@nth - position of the element to select.
+	*	@comp - comparator, true if the first argument is ordered before the second.
+	*/
+	template<typename Iterator, typename Compare>
+	__host__ __device__
+	void nth_element(Iterator first, Iterator nth, Iterator last, Compare comp)
+	{
+		if (nth == last) return;
+		size_t unbalanced = 0;
+		while (last - first > 16)
+		{
+			size_t const n = static_cast<size_t>(last - first);
+			Iterator const pivot = unbalanced < 4
+				? cudlb::median_of_three(first, first + n / 2, last - 1, comp)
+				: cudlb::median_of_medians(first, last, comp);
+			cudlb::iter_swap(first, pivot);
+			Iterator const p = cudlb::partition_pivot(first, last, comp);
+			if (p == nth) return;
+			if (nth < p) last = p;
+			else first = p + 1;
+			if (static_cast<size_t>(last - first) > n - n / 8) ++unbalanced;
+		}
+		cudlb::insertion_sort(first, last, comp);
+	}
+
+	template<typename Iterator>
+	__host__ __device__
+	void nth_element(Iterator first, Iterator nth, Iterator last)
+	{
+		using value_type = typename cudlb::remove_cv<typename cudlb::remove_reference<decltype(*first)>::value_type>::value_type;
+		cudlb::nth_element(first, nth, last, cudlb::less<value_type>());
+	}
+
+	/**
+	*	Introsort of a random access range: quicksort with median of three pivots and the partitioning of
+	*	cudlb::nth_element, recursing into the smaller side so the stack stays O(log n). A range still being split
+	*	after 2 * log2(n) levels is heap sorted, keeping the worst case O(n log n), short ranges are insertion sorted.
+	*/
+	template<typename Iterator, typename Compare>
+	__host__ __device__
+	void introsort(Iterator first, Iterator last, Compare comp, size_t depth)
+	{
+		while (last - first > 16)
+		{
+			if (depth == 0)
+			{
+				cudlb::make_heap(first, last, comp);
+				cudlb::sort_heap(first, last, comp);
+				return;
+			}
+			--depth;
+			cudlb::iter_swap(first, cudlb::median_of_three(first, first + (last - first) / 2, last - 1, comp));
+			Iterator const p = cudlb::partition_pivot(first, last, comp);
+			if (p - first < last - p)
+			{
+				cudlb::introsort(first, p, comp, depth);
+				first = p + 1;
+			}
+			else
+			{
+				cudlb::introsort(p + 1, last, comp, depth);
+				last = p;
+			}
+		}
+		cudlb::insertion_sort(first, last, comp);
+	}
+
+	template<typename Iterator, typename Compare>
+	__host__ __device__
+	void sort(Iterator first, Iterator last, Compare comp, cudlb::random_access_iterator_tag)
+	{
+		size_t depth = 0;
+		for (size_t n = static_cast<size_t>(last - first); n > 1; n >>= 1)
+			depth += 2;
+		cudlb::introsort(first, last, comp, depth);
+	}
+
+	/**
+	*	A forward range, such as the elements of a node based container, is moved into a buffer,
+	*	sorted there and moved back. Without memory for the buffer it is selection sorted in place, in O(n^2).
+	*/
+	template<typename Iterator, typename Compare>
+	__host__ __device__
+	void sort(Iterator first, Iterator last, Compare comp, cudlb::forward_iterator_tag)
+	{
+		using value_type = typename cudlb::remove_cv<typename cudlb::remove_reference<decltype(*first)>::value_type>::value_type;
+		size_t const n = static_cast<size_t>(cudlb::distance(first, last));
+		cudlb::temporary_buffer<value_type> buffer{ n };
+		if (buffer.data() == nullptr)
+		{
+			for (; first != last; ++first)
+			{
+				Iterator least = first;
+				for (Iterator i = cudlb::next(first); i != last; ++i)
+					if (comp(*i, *least)) least = i;
+				cudlb::iter_swap(first, least);
+			}
+			return;
+		}
+		for (Iterator i = first; i != last; ++i)
+			buffer.push_back(static_cast<value_type&&>(*i));
+		cudlb::sort(buffer.data(), buffer.data() + n, comp, cudlb::random_access_iterator_tag());
+		value_type* p = buffer.data();
+		for (; first != last; ++first, ++p)
+			*first = static_cast<value_type&&>(*p);
+	}
+
+	/**
+	*	Sorts a range in ascending order, the order of equivalent elements is not kept.
+	*	Random access ranges are introsorted in place, other forward ranges are sorted through a buffer.
+	*	@[first : last) - forward range of elements.
+	*	@comp - comparator, true if the first argument is ordered before the second.
+	*/
+	template<typename Iterator, typename Compare>
+	__host__ __device__
+	void sort(Iterator first, Iterator last, Compare comp)
+	{
+		cudlb::sort(first, last, comp, typename cudlb::iterator_traits<Iterator>::iterator_category());
+	}
+
+	template<typename Iterator>
+	__host__ __device__
+	void sort(Iterator first, Iterator last)
+	{
+		using value_type = typename cudlb::remove_cv<typename cudlb::remove_reference<decltype(*first)>::value_type>::value_type;
+		cudlb::sort(first, last, cudlb::less<value_type>());
+	}
+
+	/**
+	*	Number of elements up to which partial_sort and top_k keep a bounded heap,
+	*	larger selections first partition the range with a linear time selection.
+	*/
+	constexpr size_t heap_select_limit = 1024;
+
+	/**
+	*	Sorts the smallest (middle - first) elements of a range into [first : middle),
+	*	the order of the remaining elements is unspecified.
+	*	Few elements are selected with a max heap of the smallest ones seen so far, in O(n log k),
+	*	more are first moved to the front by cudlb::nth_element, in O(n + k log k).
+	*	@[first : last) - random access range of elements.
+	*	@middle - end of the range to sort.
+	*	@comp - comparator, true if the first argument is ordered before the second.
+	*/
+	template<typename Iterator, typename Compare>
+	__host__ __device__
+	void partial_sort(Iterator first, Iterator middle, Iterator last, Compare comp)
+	{
+		size_t const k = static_cast<size_t>(middle - first);
+		if (k == 0) return;
+		if (k <= heap_select_limit)
+		{
+			cudlb::make_heap(first, middle, comp);
+			for (Iterator it = middle; it != last; ++it)
+			{
+				if (comp(*it, *first))
+				{
+					cudlb::iter_swap(it, first);
+					cudlb::sift_down(first, k, 0, comp);
+				}
+			}
+		}
+		else
+		{
+			cudlb::nth_element(first, middle, last, comp);
+			cudlb::make_heap(first, middle, comp);
+		}
+		cudlb::sort_heap(first, middle, comp);
+	}
+
+	template<typename Iterator>
+	__host__ __device__
+	void partial_sort(Iterator first, Iterator middle, Iterator last)
+	{
+		using value_type = typename cudlb::remove_cv<typename cudlb::remove_reference<decltype(*first)>::value_type>::value_type;
+		cudlb::partial_sort(first, middle, last, cudlb::less<value_type>());
+	}
+
+	/**
+	*	Copies the smallest elements of a range, sorted, into an output range, as many as fit in it.
+	*	The output range is kept as a max heap of the smallest elements seen so far.
+	*	@[first : last) - input range of elements.
+	*	@[out_first : out_last) - random access output range.
+	*	@comp - comparator, true if the first argument is ordered before the second.
+	*	Returns an iterator past the last element written.
+	*/
+	template<typename InputIterator, typename OutputIterator, typename Compare>
+	__host__ __device__
+	OutputIterator partial_sort_copy(InputIterator first, InputIterator last, OutputIterator out_first, OutputIterator out_last, Compare comp)
+	{
+		OutputIterator out = out_first;
+		for (; first != last && out != out_last; ++first, ++out)
+			*out = *first;
+		size_t const k = static_cast<size_t>(out - out_first);
+		if (k == 0) return out;
+		cudlb::make_heap(out_first, out, comp);
+		for (; first != last; ++first)
+		{
+			if (comp(*first, *out_first))
+			{
+				*out_first = *first;
+				cudlb::sift_down(out_first, k, 0, comp);
+			}
+		}
+		cudlb::sort_heap(out_first, out, comp);
+		return out;
+	}
+
+	template<typename InputIterator, typename OutputIterator>
+	__host__ __device__
+	OutputIterator partial_sort_copy(InputIterator first, InputIterator last, OutputIterator out_first, OutputIterator out_last)
+	{
+		using value_type = typename cudlb::remove_cv<typename cudlb::remove_reference<decltype(*first)>::value_type>::value_type;
+		return cudlb::partial_sort_copy(first, last, out_first, out_last, cudlb::less<value_type>());
+	}
+
+	/**
+	*	Copies the @k greatest elements of a range, by @comp, into an output range in descending order.
+	*	@[first : last) - input range of elements.
+	*	@k - number of elements to select, fewer are written if the range is shorter.
+	*	@out - start of a random access output range of k elements.
+	*	@comp - comparator, true if the first argument is ordered before the second.
+	*	Returns an iterator past the last element written.
+	*/
+	template<typename InputIterator, typename OutputIterator, typename Compare>
+	__host__ __device__
+	OutputIterator top_k(InputIterator first, InputIterator last, size_t const k, OutputIterator out, Compare comp)
+	{
+		return cudlb::partial_sort_copy(first, last, out, out + k, cudlb::reverse_compare<Compare>{ comp });
+	}
+
+	/**
+	*	True for the types top_k can select by radix, integral types, float and double.
+	*/
+	template<typename T>
+	struct radix_selectable : cudlb::integral_constant<bool, cudlb::is_integral<T>::value
+		|| cudlb::is_same<typename cudlb::remove_cv<T>::value_type, float>::value
+		|| cudlb::is_same<typename cudlb::remove_cv<T>::value_type, double>::value> {};
+
+	/**
+	*	Maps a floating point value to an unsigned key with the same order, negative values have all bits flipped
+	*	and positive values the sign bit set.
+	*/
+	template<typename T>
+	__host__ __device__
+	unsigned long long radix_key(T const value, cudlb::true_type)
+	{
+		using bits_type = typename cudlb::conditional<sizeof(T) == 4, unsigned int, unsigned long long>::type;
+		bits_type const bits = cudlb::bit_cast<bits_type>(value);
+		bits_type const sign = static_cast<bits_type>(1) << (8 * sizeof(T) - 1);
+		return (bits & sign) ? static_cast<bits_type>(~bits) : static_cast<bits_type>(bits | sign);
+	}
+
+	/**
+	*	Maps an integral value to an unsigned key of the same width with the same order,
+	*	signed values have their sign bit flipped.
+	*/
+	template<typename T>
+	__host__ __device__
+	unsigned long long radix_key(T const value, cudlb::false_type)
+	{
+		unsigned long long const mask = sizeof(T) == 8 ? ~0ULL : (1ULL << (8 * sizeof(T) % 64)) - 1;
+		unsigned long long const sign = static_cast<T>(-1) < static_cast<T>(0) ? 1ULL << (8 * sizeof(T) - 1) : 0;
+		return (static_cast<unsigned long long>(value) ^ sign) & mask;
+	}
+
+	/**
+	*	Orders elements by descending radix key, used to sort the output of the radix top_k.
+	*/
+	template<typename T>
+	struct radix_key_greater {
+		__host__ __device__
+		bool operator()(T const& lhs, T const& rhs) const
+		{
+			return cudlb::radix_key(lhs, cudlb::is_floating_point<T>()) > cudlb::radix_key(rhs, cudlb::is_floating_point<T>());
+		}
+	};
+
+	/**
+	*	top_k for integral and floating point elements in their natural order.
+	*	Large selections from large ranges find the key of the k-th greatest element by radix select, one pass
+	*	per byte of the key counting the next byte of the elements which share the bytes selected so far,
+	*	then copy every element above that threshold, and as many equal to it as needed, in a last pass.
+	*	Smaller selections use a bounded heap like the generic top_k.
+	*	NOTE: NaNs are ordered by their bit pattern, positive NaNs above infinity and negative NaNs below -infinity.
+	*/
+	template<typename Iterator, typename OutputIterator>
+	__host__ __device__
+	OutputIterator top_k_radix(Iterator first, Iterator last, size_t const k, OutputIterator out, cudlb::true_type)
+	{
+		using value_type = typename cudlb::remove_cv<typename cudlb::remove_reference<decltype(*first)>::value_type>::value_type;
+		using is_float = cudlb::is_floating_point<value_type>;
+		size_t const n = static_cast<size_t>(last - first);
+		if (k <= heap_select_limit || n < 16 * heap_select_limit || k >= n)
+			return cudlb::top_k(first, last, k, out, cudlb::less<value_type>());
+
+		unsigned long long threshold = 0;
+		unsigned long long selected_mask = 0;
+		size_t equal_wanted = k;	// Elements still to select among those sharing the selected bytes.
+		for (int shift = 8 * static_cast<int>(sizeof(value_type)) - 8; shift >= 0; shift -= 8)
+		{
+			size_t count[256] = {};
+			for (Iterator it = first; it != last; ++it)
+			{
+				unsigned long long const key = cudlb::radix_key(*it, is_float());
+				if ((key & selected_mask) == threshold) ++count[(key >> shift) & 255];
+			}
+			unsigned int digit = 255;
+			for (; count[digit] < equal_wanted; --digit)
+				equal_wanted -= count[digit];
+			threshold |= static_cast<unsigned long long>(digit) << shift;
+			selected_mask |= 255ULL << shift;
+		}
+
+		OutputIterator result = out;
+		for (Iterator it = first; it != last; ++it)
+		{
+			unsigned long long const key = cudlb::radix_key(*it, is_float());
+			if (key > threshold || (key == threshold && equal_wanted != 0))
+			{
+				if (key == threshold) --equal_wanted;
+				*result = *it;
+				++result;
+			}
+		}
+		cudlb::make_heap(out, result, cudlb::radix_key_greater<value_type>());
+		cudlb::sort_heap(out, result, cudlb::radix_key_greater<value_type>());
+		return result;
+	}
+
+	template<typename Iterator, typename OutputIterator>
+	__host__ __device__
+	OutputIterator top_k_radix(Iterator first, Iterator last, size_t const k, OutputIterator out, cudlb::false_type)
+	{
+		using value_type = typename cudlb::remove_cv<typename cudlb::remove_reference<decltype(*first)>::value_type>::value_type;
+		return cudlb::top_k(first, last, k, out, cudlb::less<value_type>());
+	}
+
+	/**
+	*	Copies the @k greatest elements of a range into an output range in descending order.
+	*	Integral and floating point elements of large random access ranges are selected by radix select.
+	*	@[first : last) - random access range of elements.
+	*	@k - number of elements to select, fewer are written if the range is shorter.
+	*	@out - start of a random access output range of k elements.
+	*	Returns an iterator past the last element written.
+	*/
+	template<typename Iterator, typename OutputIterator>
+	__host__ __device__
+	OutputIterator top_k(Iterator first, Iterator last, size_t const k, OutputIterator out)
+	{
+		using value_type = typename cudlb::remove_cv<typename cudlb::remove_reference<decltype(*first)>::value_type>::value_type;
+		return cudlb::top_k_radix(first, last, k, out, cudlb::radix_selectable<value_type>());
+	}
+
+	/**
+	*	Output iterator which only counts the elements written through it, for the counting set operations.
+	*/
+	struct counting_output_iterator {
+		size_t count;
+
+		__host__ __device__
+		counting_output_iterator& operator*()
+		{
+			return *this;
+		}
+
+		template<typename T>
+		__host__ __device__
+		counting_output_iterator& operator=(T const&)
+		{
+			++count;
+			return *this;
+		}
+
+		__host__ __device__
+		counting_output_iterator& operator++()
+		{
+			return *this;
+		}
+	};
+
+	/**
+	*	Size ratio of two sorted ranges from which the set operations gallop through the longer range.
+	*/
+	constexpr size_t set_gallop_ratio = 16;
+
+	/**
+	*	Returns the first element of a sorted range which is not less than a value, found by exponential search:
+	*	steps of 1, 3, 7, 15... elements until one is passed, then a binary search of the last step.
+	*	Takes O(log d) comparisons where d is the distance to the result, whatever the length of the range.
+	*/
+	template<typename Iterator, typename T, typename Compare>
+	__host__ __device__
+	Iterator gallop_lower_bound(Iterator first, Iterator last, T const& value, Compare comp)
+	{
+		size_t const n = static_cast<size_t>(last - first);
+		if (n == 0 || !comp(*first, value)) return first;
+		size_t passed = 0;	// Last position known to be less than value.
+		size_t bound = 1;
+		while (bound < n && comp(first[bound], value))
+		{
+			passed = bound;
+			bound = 2 * bound + 1;
+		}
+		return cudlb::lower_bound(first + (passed + 1), first + (bound < n ? bound : n), value, comp);
+	}
+
+	template<typename Iterator, typename T, typename Compare>
+	__host__ __device__
+	Iterator linear_lower_bound(Iterator first, Iterator last, T const& value, Compare comp, cudlb::input_iterator_tag)
+	{
+		while (first != last && comp(*first, value))
+			++first;
+		return first;
+	}
+
+	/**
+	*	Scans a block of 32-bit integers at a time, the less lanes of a sorted block form a prefix,
+	*	so the block either is skipped whole or holds the result.
+	*/
+	template<typename T, typename U>
+	__host__ __device__
+	T* linear_lower_bound_contiguous(T* first, T* last, U const value, cudlb::true_type)
+	{
+	#if !defined(__CUDA_ARCH__) && defined(CUDLB_SSE2)
+		constexpr size_t lanes = cudlb::simd_block_bytes() / sizeof(T);
+		unsigned long long const all = cudlb::simd_lane_mask<T>() & ((1ULL << (lanes * sizeof(T))) - 1);
+		for (; static_cast<size_t>(last - first) >= lanes; first += lanes)
+		{
+			unsigned long long const mask = cudlb::less_block<U>(first, value) & all;
+			if (mask != all) return first + cudlb::popcount(mask);
+		}
+	#endif
+		while (first != last && *first < value)
+			++first;
+		return first;
+	}
+
+	template<typename T, typename U>
+	__host__ __device__
+	T* linear_lower_bound_contiguous(T* first, T* last, U const& value, cudlb::false_type)
+	{
+		return cudlb::linear_lower_bound(first, last, value, cudlb::less<U>(), cudlb::input_iterator_tag());
+	}
+
+	/**
+	*	Contiguous ranges scanned with the default comparator are block compared for 32-bit integers.
+	*/
+	template<typename Iterator, typename U>
+	__host__ __device__
+	Iterator linear_lower_bound(Iterator first, Iterator last, U const& value, cudlb::less<U>, cudlb::contiguous_iterator_tag)
+	{
+		using T = typename cudlb::remove_reference<decltype(*first)>::value_type;
+		using tag = cudlb::integral_constant<bool, cudlb::is_same<typename cudlb::remove_cv<T>::value_type, U>::value
+			&& cudlb::simd_kind<U>::value == 4>;
+		T* const p = cudlb::to_address(first);
+		return first + (cudlb::linear_lower_bound_contiguous(p, p + (last - first), value, tag()) - p);
+	}
+
+	/**
+	*	Returns the first element of a sorted range which is not less than a value, found by a linear scan.
+	*/
+	template<typename Iterator, typename T, typename Compare>
+	__host__ __device__
+	Iterator linear_lower_bound(Iterator first, Iterator last, T const& value, Compare comp)
+	{
+		return cudlb::linear_lower_bound(first, last, value, comp, typename cudlb::iterator_traits<Iterator>::iterator_category());
+	}
+
+	/**
+	*	Decides whether a set operation gallops through a range, which is done if it is random access
+	*	and 16 or more times longer than the other one. Ranges of other iterators are always scanned.
+	*/
+	template<typename IteratorA, typename IteratorB>
+	__host__ __device__
+	bool set_gallop(IteratorA first_a, IteratorA last_a, IteratorB first_b, IteratorB last_b, cudlb::true_type)
+	{
+		return static_cast<size_t>(last_a - first_a) / set_gallop_ratio >= static_cast<size_t>(last_b - first_b);
+	}
+
+	template<typename IteratorA, typename IteratorB>
+	__host__ __device__
+	bool set_gallop(IteratorA, IteratorA, IteratorB, IteratorB, cudlb::false_type)
+	{
+		return false;
+	}
+
+	template<typename IteratorA, typename IteratorB>
+	__host__ __device__
+	bool set_gallop(IteratorA first_a, IteratorA last_a, IteratorB first_b, IteratorB last_b)
+	{
+		using random_access = cudlb::integral_constant<bool, cudlb::is_iterator_category<IteratorA, cudlb::random_access_iterator_tag>::value
+			&& cudlb::is_iterator_category<IteratorB, cudlb::random_access_iterator_tag>::value>;
+		return cudlb::set_gallop(first_a, last_a, first_b, last_b, random_access());
+	}
+
+	template<typename Iterator, typename T, typename Compare>
+	__host__ __device__
+	Iterator set_advance(Iterator first, Iterator last, T const& value, Compare comp, cudlb::true_type)
+	{
+		return cudlb::gallop_lower_bound(first, last, value, comp);
+	}
+
+	template<typename Iterator, typename T, typename Compare>
+	__host__ __device__
+	Iterator set_advance(Iterator first, Iterator last, T const& value, Compare comp, cudlb::false_type)
+	{
+		return cudlb::linear_lower_bound(first, last, value, comp);
+	}
+
+	/**
+	*	Skips the elements of a sorted range which are less than a value, by galloping or by a linear scan.
+	*/
+	template<typename Iterator, typename T, typename Compare>
+	__host__ __device__
+	Iterator set_advance(Iterator first, Iterator last, T const& value, Compare comp, bool const gallop)
+	{
+		using random_access = cudlb::integral_constant<bool, cudlb::is_iterator_category<Iterator, cudlb::random_access_iterator_tag>::value>;
+		return gallop ? cudlb::set_advance(first, last, value, comp, random_access()) : cudlb::linear_lower_bound(first, last, value, comp);
+	}
+
+	/**
+	*	Copies the elements found in both of two sorted ranges, with the multiset semantics of the standard library:
+	*	an element found m times in the first range and n times in the second is copied min(m, n) times,
+	*	from the first range.
+	*	Ranges of similar lengths are merged, scanning blocks of 32-bit integers at a time, a random access range
+	*	16 or more times longer than the other is galloped through, in O(m log(n / m)) comparisons.
+	*	@[first_a : last_a) - first sorted forward range.
+	*	@[first_b : last_b) - second sorted forward range.
+	*	@out - start of the output range.
+	*	@comp - comparator, true if the first argument is ordered before the second.
+	*	Returns an iterator past the last element written.
+	*/
+	template<typename IteratorA, typename IteratorB, typename OutputIterator, typename Compare>
+	__host__ __device__
+	OutputIterator set_intersection(IteratorA first_a, IteratorA last_a, IteratorB first_b, IteratorB last_b, OutputIterator out, Compare comp)
+	{
+		bool const gallop_a = cudlb::set_gallop(first_a, last_a, first_b, last_b);
+		bool const gallop_b = cudlb::set_gallop(first_b, last_b, first_a, last_a);
+		while (first_a != last_a && first_b != last_b)
+		{
+			if (comp(*first_a, *first_b)) first_a = cudlb::set_advance(first_a, last_a, *first_b, comp, gallop_a);
+			else if (comp(*first_b, *first_a)) first_b = cudlb::set_advance(first_b, last_b, *first_a, comp, gallop_b);
+			else
+			{
+				*out = *first_a;
+				++out;
+				++first_a;
+				++first_b;
+			}
+		}
+		return out;
+	}
+
+	template<typename IteratorA, typename IteratorB, typename OutputIterator>
+	__host__ __device__
+	OutputIterator set_intersection(IteratorA first_a, IteratorA last_a, IteratorB first_b, IteratorB last_b, OutputIterator out)
+	{
+		using value_type = typename cudlb::remove_cv<typename cudlb::remove_reference<decltype(*first_a)>::value_type>::value_type;
+		return cudlb::set_intersection(first_a, last_a, first_b, last_b, out, cudlb::less<value_type>());
+	}
+
+	/**
+	*	Copies the elements found in either of two sorted ranges, with the multiset semantics of the standard library:
+	*	an element found m times in the first range and n times in the second is copied max(m, n) times.
+	*	Runs of one range which come before the next element of the other are found like in cudlb::set_intersection.
+	*	Returns an iterator past the last element written.
+	*/
+	template<typename IteratorA, typename IteratorB, typename OutputIterator, typename Compare>
+	__host__ __device__
+	OutputIterator set_union(IteratorA first_a, IteratorA last_a, IteratorB first_b, IteratorB last_b, OutputIterator out, Compare comp)
+	{
+		bool const gallop_a = cudlb::set_gallop(first_a, last_a, first_b, last_b);
+		bool const gallop_b = cudlb::set_gallop(first_b, last_b, first_a, last_a);
+		while (first_a != last_a && first_b != last_b)
+		{
+			if (comp(*first_a, *first_b))
+			{
+				IteratorA const run = cudlb::set_advance(first_a, last_a, *first_b, comp, gallop_a);
+				out = cudlb::copy(first_a, run, out);
+				first_a = run;
+			}
+			else if (comp(*first_b, *first_a))
+			{
+				IteratorB const run = cudlb::set_advance(first_b, last_b, *first_a, comp, gallop_b);
+				out = cudlb::copy(first_b, run, out);
+				first_b = run;
+			}
+			else
+			{
+				*out = *first_a;
+				++out;
+				++first_a;
+				++first_b;
+			}
+		}
+		out = cudlb::copy(first_a, last_a, out);
+		return cudlb::copy(first_b, last_b, out);
+	}
+
+	template<typename IteratorA, typename IteratorB, typename OutputIterator>
+	__host__ __device__
+	OutputIterator set_union(IteratorA first_a, IteratorA last_a, IteratorB first_b, IteratorB last_b, OutputIterator out)
+	{
+		using value_type = typename cudlb::remove_cv<typename cudlb::remove_reference<decltype(*first_a)>::value_type>::value_type;
+		return cudlb::set_union(first_a, last_a, first_b, last_b, out, cudlb::less<value_type>());
+	}
+
+	/**
+	*	Copies the elements of the first sorted range which are not found in the second one, with the multiset
+	*	semantics of the standard library: an element found m times in the first range and n times in the second
+	*	is copied max(m - n, 0) times.
+	*	Runs of one range which come before the next element of the other are found like in cudlb::set_intersection.
+	*	Returns an iterator past the last element written.
+	*/
+	template<typename IteratorA, typename IteratorB, typename OutputIterator, typename Compare>
+	__host__ __device__
+	OutputIterator set_difference(IteratorA first_a, IteratorA last_a, IteratorB first_b, IteratorB last_b, OutputIterator out, Compare comp)
+	{
+		bool const gallop_a = cudlb::set_gallop(first_a, last_a, first_b, last_b);
+		bool const gallop_b = cudlb::set_gallop(first_b, last_b, first_a, last_a);
+		while (first_a != last_a && first_b != last_b)
+		{
+			if (comp(*first_a, *first_b))
+			{
+				IteratorA const run = cudlb::set_advance(first_a, last_a, *first_b, comp, gallop_a);
+				out = cudlb::copy(first_a, run, out);
+				first_a = run;
+			}
+			else if (comp(*first_b, *first_a))
+			{
+				first_b = cudlb::set_advance(first_b, last_b, *first_a, comp, gallop_b);
+			}
+			else
+			{
+				++first_a;
+				++first_b;
+			}
+		}
+		return cudlb::copy(first_a, last_a, out);
+	}
+
+	template<typename IteratorA, typename IteratorB, typename OutputIterator>
+	__host__ __device__
+	OutputIterator set_difference(IteratorA first_a, IteratorA last_a, IteratorB first_b, IteratorB last_b, OutputIterator out)
+	{
+		using value_type = typename cudlb::remove_cv<typename cudlb::remove_reference<decltype(*first_a)>::value_type>::value_type;
+		return cudlb::set_difference(first_a, last_a, first_b, last_b, out, cudlb::less<value_type>());
+	}
+
+	/**
+	*	Checks if every element of the second sorted range is found in the first one, as many times as in the second.
+	*	Runs of the first range which come before the next element of the second are found like in cudlb::set_intersection.
+	*/
+	template<typename IteratorA, typename IteratorB, typename Compare>
+	__host__ __device__
+	bool includes(IteratorA first_a, IteratorA last_a, IteratorB first_b, IteratorB last_b, Compare comp)
+	{
+		bool const gallop_a = cudlb::set_gallop(first_a, last_a, first_b, last_b);
+		for (; first_b != last_b; ++first_b, ++first_a)
+		{
+			first_a = cudlb::set_advance(first_a, last_a, *first_b, comp, gallop_a);
+			if (first_a == last_a || comp(*first_b, *first_a)) return false;
+		}
+		return true;
+	}
+
+	template<typename IteratorA, typename IteratorB>
+	__host__ __device__
+	bool includes(IteratorA first_a, IteratorA last_a, IteratorB first_b, IteratorB last_b)
+	{
+		using value_type = typename cudlb::remove_cv<typename cudlb::remove_reference<decltype(*first_a)>::value_type>::value_type;
+		return cudlb::includes(first_a, last_a, first_b, last_b, cudlb::less<value_type>());
+	}
+
+	/**
+	*	Returns the number of elements cudlb::set_intersection would write, without writing them.
+	*/
+	template<typename IteratorA, typename IteratorB, typename Compare>
+	__host__ __device__
+	size_t set_intersection_count(IteratorA first_a, IteratorA last_a, IteratorB first_b, IteratorB last_b, Compare comp)
+	{
+		return cudlb::set_intersection(first_a, last_a, first_b, last_b, cudlb::counting_output_iterator{ 0 }, comp).count;
+	}
+
+	template<typename IteratorA, typename IteratorB>
+	__host__ __device__
+	size_t set_intersection_count(IteratorA first_a, IteratorA last_a, IteratorB first_b, IteratorB last_b)
+	{
+		using value_type = typename cudlb::remove_cv<typename cudlb::remove_reference<decltype(*first_a)>::value_type>::value_type;
+		return cudlb::set_intersection_count(first_a, last_a, first_b, last_b, cudlb::less<value_type>());
+	}
+
+	/**
+	*	Returns the number of elements cudlb::set_union would write, without writing them.
+	*	Each element common to both ranges is written once, so the count follows from the intersection.
+	*/
+	template<typename IteratorA, typename IteratorB, typename Compare>
+	__host__ __device__
+	size_t set_union_count(IteratorA first_a, IteratorA last_a, IteratorB first_b, IteratorB last_b, Compare comp)
+	{
+		size_t const common = cudlb::set_intersection_count(first_a, last_a, first_b, last_b, comp);
+		return static_cast<size_t>(cudlb::distance(first_a, last_a)) + static_cast<size_t>(cudlb::distance(first_b, last_b)) - common;
+	}
+
+	template<typename IteratorA, typename IteratorB>
+	__host__ __device__
+	size_t set_union_count(IteratorA first_a, IteratorA last_a, IteratorB first_b, IteratorB last_b)
+	{
+		using value_type = typename cudlb::remove_cv<typename cudlb::remove_reference<decltype(*first_a)>::value_type>::value_type;
+		return cudlb::set_union_count(first_a, last_a, first_b, last_b, cudlb::less<value_type>());
+	}
+
+	/**
+	*	Returns the number of elements cudlb::set_difference would write, without writing them.
+	*/
+	template<typename IteratorA, typename IteratorB, typename Compare>
+	__host__ __device__
+	size_t set_difference_count(IteratorA first_a, IteratorA last_a, IteratorB first_b, IteratorB last_b, Compare comp)
+	{
+		return static_cast<size_t>(cudlb::distance(first_a, last_a)) - cudlb::set_intersection_count(first_a, last_a, first_b, last_b, comp);
+	}
+
+	template<typename IteratorA, typename IteratorB>
+	__host__ __device__
+	size_t set_difference_count(IteratorA first_a, IteratorA last_a, IteratorB first_b, IteratorB last_b)
+	{
+		using value_type = typename cudlb::remove_cv<typename cudlb::remove_reference<decltype(*first_a)>::value_type>::value_type;
+		return cudlb::set_difference_count(first_a, last_a, first_b, last_b, cudlb::less<value_type>());
+	}
+
+	/**
+	*	Orders two elements with conditional moves instead of a branch, for elements held in registers.
+	*/
+	template<typename T, typename Compare>
+	__host__ __device__
+	void compare_exchange(T& a, T& b, Compare comp)
+	{
+		bool const swap = comp(b, a);
+		T const lo = swap ? b : a;
+		T const hi = swap ? a : b;
+		a = lo;
+		b = hi;
+	}
+
+	/**
+	*	Enumerates the comparators of Batcher's odd-even merge sorting network for P elements, P a power of two,
+	*	in the order they apply, calling f(lo, hi) for each of them. Comparators reaching past the first @n elements
+	*	are skipped, which sorts as if the missing elements were greater than all others.
+	*	The one enumeration behind both the runtime network and the compile time network of static_network_sort.
+	*/
+	template<typename F>
+	__host__ __device__
+	constexpr void for_each_batcher_comparator(size_t const P, size_t const n, F& f)
+	{
+		for (size_t p = 1; p < P; p <<= 1)
+		{
+			for (size_t k = p; k >= 1; k >>= 1)
+			{
+				for (size_t j = k % p; j + k < P; j += 2 * k)
+				{
+					for (size_t i = 0; i < k && i + j + k < P; ++i)
+					{
+						if ((i + j) / (2 * p) == (i + j + k) / (2 * p) && i + j + k < n)
+							f(i + j, i + j + k);
+					}
+				}
+			}
+		}
+	}
+
+	/**
+	*	Comparator of the runtime network, orders two elements of a local array.
+	*/
+	template<typename T, typename Compare>
+	struct network_compare_exchange {
+		T* v;
+		Compare& comp;
+
+		__host__ __device__
+		void operator()(size_t const lo, size_t const hi)
+		{
+			cudlb::compare_exchange(v[lo], v[hi], comp);
+		}
+	};
+
+	/**
+	*	Batcher's odd-even merge sorting network for P elements, P a power of two, applied to the first @n elements.
+	*	P is a compile time constant so that the loops unroll into a fixed sequence of comparators.
+	*/
+	template<size_t P, typename T, typename Compare>
+	__host__ __device__
+	void odd_even_merge_network(T* v, size_t const n, Compare comp)
+	{
+		cudlb::network_compare_exchange<T, Compare> f{ v, comp };
+		cudlb::for_each_batcher_comparator(P, n, f);
+	}
+
+	/**
+	*	Sorts up to 32 arithmetic elements in a local array, which the compiler keeps in registers.
+	*/
+	template<typename Iterator, typename Compare>
+	__host__ __device__
+	void network_sort(Iterator first, size_t const n, Compare comp, cudlb::true_type)
+	{
+		using value_type = typename cudlb::remove_cv<typename cudlb::remove_reference<decltype(*first)>::value_type>::value_type;
+		value_type v[32];
+		for (size_t i = 0; i != n; ++i)
+			v[i] = first[i];
+		if (n <= 4) cudlb::odd_even_merge_network<4>(v, n, comp);
+		else if (n <= 8) cudlb::odd_even_merge_network<8>(v, n, comp);
+		else if (n <= 16) cudlb::odd_even_merge_network<16>(v, n, comp);
+		else cudlb::odd_even_merge_network<32>(v, n, comp);
+		for (size_t i = 0; i != n; ++i)
+			first[i] = v[i];
+	}
+
+	/**
+	*	Sorts up to 32 elements of other types in place, with insertion sort.
+	*/
+	template<typename Iterator, typename Compare>
+	__host__ __device__
+	void network_sort(Iterator first, size_t const n, Compare comp, cudlb::false_type)
+	{
+		cudlb::insertion_sort(first, first + n, comp);
+	}
+
+	/**
+	*	Sorts a range of at most 32 elements.
+	*	Arithmetic elements are sorted by a sorting network in registers, other elements by insertion sort.
+	*	@first - first element of the random access range.
+	*	@n - number of elements, at most 32.
+	*	@comp - comparator, true if the first argument is ordered before the second.
+	*	NOTE: The network does not keep the order of equivalent elements.
+	*/
+	template<typename Iterator, typename Compare>
+	__host__ __device__
+	void network_sort(Iterator first, size_t const n, Compare comp)
+	{
+		using value_type = typename cudlb::remove_cv<typename cudlb::remove_reference<decltype(*first)>::value_type>::value_type;
+		using tag = cudlb::integral_constant<bool, cudlb::simd_kind<value_type>::value != 0>;
+		cudlb::network_sort(first, n, comp, tag());
+	}
+
+	/**
+	*	Looks for one comparator of the network while cudlb::for_each_batcher_comparator enumerates them.
+	*/
+	struct batcher_comparator_search {
+		size_t index;
+		bool high;
+		size_t count;
+		size_t position;
+
+		__host__ __device__
+		constexpr void operator()(size_t const lo, size_t const hi)
+		{
+			if (count == index) position = high ? hi : lo;
+			++count;
+		}
+	};
+
+	/**
+	*	Returns a comparator of Batcher's odd-even merge sorting network for n elements, in the order they apply:
+	*	the network for the next power of two, without the comparators reaching past n.
+	*	@index - position of the comparator.
+	*	@high - true for the position of the greater element of the comparator, false for the smaller.
+	*	Returns the position, or the number of comparators if @index is past the last one.
+	*	NOTE: Meant for compile time evaluation only, finding one comparator takes as long as enumerating all of them.
+	*/
+	__host__ __device__
+	constexpr size_t batcher_comparator(size_t const n, size_t const index, bool const high)
+	{
+		size_t padded = 1;
+		while (padded < n)
+			padded <<= 1;
+		cudlb::batcher_comparator_search search{ index, high, 0, 0 };
+		cudlb::for_each_batcher_comparator(padded, n, search);
+		return index < search.count ? search.position : search.count;
+	}
+
+	/**
+	*	Applies the comparators K of the sorting network for N elements, every position a compile time constant,
+	*	so the network compiles to straight line code.
+	*/
+	template<size_t N, typename Iterator, typename Compare, size_t... K>
+	__host__ __device__
+	void apply_sorting_network(Iterator first, Compare comp, cudlb::index_sequence<K...>)
+	{
+		int const expand[] = { 0, (cudlb::compare_exchange(
+			first[cudlb::integral_constant<size_t, cudlb::batcher_comparator(N, K, false)>::value],
+			first[cudlb::integral_constant<size_t, cudlb::batcher_comparator(N, K, true)>::value], comp), 0)... };
+		// Networks of up to 1 element have no comparators.
+		(void)expand;
+		(void)first;
+		(void)comp;
+	}
+
+	/**
+	*	Sorts N elements, N known at compile time, with Batcher's odd-even merge sorting network,
+	*	63 comparators for 16 elements and 191 for 32.
+	*	@first - first element of the random access range.
+	*	@comp - comparator, true if the first argument is ordered before the second.
+	*	NOTE: The network does not keep the order of equivalent elements.
+	*/
+	template<size_t N, typename Iterator, typename Compare>
+	__host__ __device__
+	void static_network_sort(Iterator first, Compare comp)
+	{
+		constexpr size_t comparators = cudlb::batcher_comparator(N, ~static_cast<size_t>(0), false);
+		cudlb::apply_sorting_network<N>(first, comp, cudlb::make_index_sequence<comparators>());
 	}
-}
\ No newline at end of file
+}
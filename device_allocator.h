@@ -1,4 +1,5 @@
 #pragma once 
+#include <new>
 #include "device_utility.h"
 
 
@@ -15,6 +16,14 @@ namespace cudlb
 		using const_reference =	T const&;
 		using size_type = size_t;
 
+		/**
+		*	Obtains the allocator type for objects of type U, used by containers which allocate internal node types.
+		*/
+		template<typename U>
+		struct rebind {
+			using other = device_allocator<U>;
+		};
+
 		/**
 		*	Constructors
 		*/
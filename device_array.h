@@ -14,6 +14,11 @@ namespace cudlb
 		using const_reference = T const&;
 		using size_type = size_t;
 
+	/**
+	*	Arrays of up to unroll_limit elements are filled and compared by unrolled code.
+	*/
+	static constexpr size_type unroll_limit = 64;
+
 	/**
 	*	Returns a constant iterator to the first object in the device array sequence.
 	*/
@@ -29,7 +34,7 @@ namespace cudlb
 	__device__
 	const_iterator constexpr end() const
 	{
-		return array_data[N];
+		return array_data + N;
 	}
 
 	/**
@@ -87,8 +92,24 @@ namespace cudlb
 	__device__
 	void constexpr fill(value_type const& val)
 	{
-		for (auto i = 0; i < N; ++i)
-			array_data[i] = val; 
+		fill_elements(val, cudlb::integral_constant<bool, (N <= unroll_limit)>());
+	}
+
+	/**
+	*	Evaluates an element-wise expression into the array, in a single loop without temporaries.
+	*	@e - expression built by the operators of device_expression.h, at least as long as the array.
+	*	NOTE: The expression may refer to this array, every element is read before it is written.
+	*	Throws without writing any element if a container of the expression is shorter than the array.
+	*/
+	template<typename E>
+	__device__
+	device_array& operator=(cudlb::expression<E> const& e)
+	{
+		E const& x = e.self();
+		if (x.size() != 0 && x.size() < N) throw;
+		for (size_type i = 0; i != N; ++i)
+			array_data[i] = x[i];
+		return *this;
 	}
 
 	/**
@@ -126,6 +147,27 @@ namespace cudlb
 	}
 
 	private: 
+		__device__
+		void constexpr fill_elements(value_type const& val, cudlb::true_type)
+		{
+			fill_unrolled(val, cudlb::make_index_sequence<N>());
+		}
+
+		__device__
+		void constexpr fill_elements(value_type const& val, cudlb::false_type)
+		{
+			for (size_type i = 0; i < N; ++i)
+				array_data[i] = val;
+		}
+
+		template<size_t... I>
+		__device__
+		void constexpr fill_unrolled(value_type const& val, cudlb::index_sequence<I...>)
+		{
+			int const expand[] = { 0, (array_data[I] = val, 0)... };
+			(void)expand;
+		}
+
 		/**
 		*	Array data. 
 		*	No constructor/destructor/copy/move required
@@ -133,6 +175,118 @@ namespace cudlb
 		value_type array_data[N];
 	};
 
+	/**
+	*	Compares all elements of two arrays without branches, the comparisons combined with a bitwise AND.
+	*/
+	template<typename T, size_t N, size_t... I>
+	__device__
+	bool equal_unrolled(device_array<T, N> const& a, device_array<T, N> const& b, cudlb::index_sequence<I...>)
+	{
+		bool result = true;
+		int const expand[] = { 0, (result &= static_cast<bool>(a[I] == b[I]), 0)... };
+		(void)expand;
+		return result;
+	}
+
+	template<typename T, size_t N>
+	__device__
+	bool equal(device_array<T, N> const& a, device_array<T, N> const& b, cudlb::true_type)
+	{
+		return cudlb::equal_unrolled(a, b, cudlb::make_index_sequence<N>());
+	}
+
+	template<typename T, size_t N>
+	__device__
+	bool equal(device_array<T, N> const& a, device_array<T, N> const& b, cudlb::false_type)
+	{
+		return cudlb::equal(a.begin(), a.end(), b.begin(), b.end());
+	}
+
+	/**
+	*	Checks if two arrays hold equal elements, with unrolled comparisons for arrays of up to 64 elements.
+	*/
+	template<typename T, size_t N>
+	__device__
+	bool equal(device_array<T, N> const& a, device_array<T, N> const& b)
+	{
+		return cudlb::equal(a, b, cudlb::integral_constant<bool, (N <= device_array<T, N>::unroll_limit)>());
+	}
+
+	/**
+	*	Compares all elements of two arrays in a fixed sequence of steps, each step keeping the result of the first
+	*	differing pair found so far: -1 if a was less, 1 if b was less, 0 while all pairs were equivalent.
+	*/
+	template<typename T, size_t N, size_t... I>
+	__device__
+	bool lexicographical_compare_unrolled(device_array<T, N> const& a, device_array<T, N> const& b, cudlb::index_sequence<I...>)
+	{
+		int order = 0;
+		int const expand[] = { 0, (order = order != 0 ? order : (a[I] < b[I] ? -1 : (b[I] < a[I] ? 1 : 0)), 0)... };
+		(void)expand;
+		return order < 0;
+	}
+
+	template<typename T, size_t N>
+	__device__
+	bool lexicographical_compare(device_array<T, N> const& a, device_array<T, N> const& b, cudlb::true_type)
+	{
+		return cudlb::lexicographical_compare_unrolled(a, b, cudlb::make_index_sequence<N>());
+	}
+
+	template<typename T, size_t N>
+	__device__
+	bool lexicographical_compare(device_array<T, N> const& a, device_array<T, N> const& b, cudlb::false_type)
+	{
+		return cudlb::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end());
+	}
+
+	/**
+	*	Checks if the elements of the first array are lexicographically less than those of the second,
+	*	with unrolled comparisons for arrays of up to 64 elements.
+	*/
+	template<typename T, size_t N>
+	__device__
+	bool lexicographical_compare(device_array<T, N> const& a, device_array<T, N> const& b)
+	{
+		return cudlb::lexicographical_compare(a, b, cudlb::integral_constant<bool, (N <= device_array<T, N>::unroll_limit)>());
+	}
+
+	template<typename T, size_t N, typename Compare>
+	__device__
+	void sort(device_array<T, N>& arr, Compare comp, cudlb::true_type)
+	{
+		cudlb::static_network_sort<N>(arr.data(), comp);
+	}
+
+	template<typename T, size_t N, typename Compare>
+	__device__
+	void sort(device_array<T, N>& arr, Compare comp, cudlb::false_type)
+	{
+		cudlb::sort(arr.data(), arr.data() + N, comp);
+	}
+
+	/**
+	*	Sorts the elements of an array.
+	*	Arrays of up to 32 elements are sorted by a sorting network generated at compile time, a straight line
+	*	sequence of compare-exchanges without branches or loops, larger ones by introsort.
+	*	@arr - array to sort.
+	*	@comp - comparator, true if the first argument is ordered before the second.
+	*	NOTE: The order of equivalent elements is not kept.
+	*/
+	template<typename T, size_t N, typename Compare>
+	__device__
+	void sort(device_array<T, N>& arr, Compare comp)
+	{
+		cudlb::sort(arr, comp, cudlb::integral_constant<bool, (N <= 32)>());
+	}
+
+	template<typename T, size_t N>
+	__device__
+	void sort(device_array<T, N>& arr)
+	{
+		cudlb::sort(arr, cudlb::less<T>());
+	}
+
 	/**
 	*	Operator overloads for device_array - ==, !=, <, >, <=, >=.
 	*/
@@ -140,7 +294,7 @@ namespace cudlb
 	__device__
 	bool operator==(device_array<T, N> const& rhs, device_array<T, N> const& lhs)
 	{
-		return cudlb::equal(rhs.begin(), rhs.end(), lhs.begin(), lhs.end());
+		return cudlb::equal(rhs, lhs);
 	}
 
 	template<typename T, size_t N> 
@@ -154,7 +308,7 @@ namespace cudlb
 	__device__
 	bool operator<(device_array<T, N> const& rhs, device_array<T, N> const& lhs)
 	{
-		return cudlb::lexicographical_compare(rhs.begin(), rhs.end(), lhs.begin(), lhs.end());
+		return cudlb::lexicographical_compare(rhs, lhs);
 	}
 
 	template<typename T, size_t N> 
@@ -0,0 +1,155 @@
+#pragma once
+#include "device_utility.h"
+#include "device_type_traits.h"
+#if !defined(__CUDACC__)
+#include <atomic>
+#endif
+
+namespace cudlb
+{
+	/**
+	*	Unsigned integer type with the same size as T, used to pass T through the CUDA atomic intrinsics.
+	*/
+	template<size_t Size>
+	struct atomic_word;
+
+	template<>
+	struct atomic_word<4> {
+		using type = unsigned int;
+	};
+
+	template<>
+	struct atomic_word<8> {
+		using type = unsigned long long;
+	};
+
+	/**
+	*	Atomic object of a trivially copyable type with a size of 4 or 8 bytes.
+	*	In device code the operations map to the CUDA atomic intrinsics, in host builds to std::atomic,
+	*	so that code built on it can be stress tested with std::thread.
+	*	NOTE: Loads have acquire, stores release and read-modify-write operations acquire-release semantics.
+	*	On the device this is achieved with __threadfence(), which orders memory accesses for the whole grid.
+	*/
+	template<typename T>
+	class atomic {
+		static_assert(sizeof(T) == 4 || sizeof(T) == 8, "cudlb::atomic requires a type of 4 or 8 bytes");
+	public:
+		using value_type = T;
+		using word = typename cudlb::atomic_word<sizeof(T)>::type;
+
+		__device__
+		explicit atomic(T const desired)
+			: value{ desired } {}
+
+		atomic(atomic const&) = delete;
+
+		atomic const& operator=(atomic const&) = delete;
+
+		/**
+		*	Returns the current value.
+		*/
+		__device__
+		T load() const
+		{
+		#if defined(__CUDACC__)
+			T const result = cudlb::bit_cast<T>(*reinterpret_cast<word const volatile*>(&value));
+			__threadfence();
+			return result;
+		#else
+			return value.load(std::memory_order_acquire);
+		#endif
+		}
+
+		/**
+		*	Replaces the current value with @desired.
+		*/
+		__device__
+		void store(T const desired)
+		{
+		#if defined(__CUDACC__)
+			__threadfence();
+			*reinterpret_cast<word volatile*>(&value) = cudlb::bit_cast<word>(desired);
+		#else
+			value.store(desired, std::memory_order_release);
+		#endif
+		}
+
+		/**
+		*	Replaces the current value with @desired, if it is bitwise equal to @expected.
+		*	@expected - value the object is expected to hold, receives the actual value if the exchange failed.
+		*	@desired - new value.
+		*	Returns true if the value was replaced.
+		*/
+		__device__
+		bool compare_exchange(T& expected, T const desired)
+		{
+		#if defined(__CUDACC__)
+			word const e = cudlb::bit_cast<word>(expected);
+			__threadfence();
+			word const old = atomicCAS(reinterpret_cast<word*>(&value), e, cudlb::bit_cast<word>(desired));
+			__threadfence();
+			expected = cudlb::bit_cast<T>(old);
+			return old == e;
+		#else
+			return value.compare_exchange_strong(expected, desired, std::memory_order_acq_rel, std::memory_order_acquire);
+		#endif
+		}
+
+		/**
+		*	Replaces the current value with @desired and returns the previous value.
+		*/
+		__device__
+		T exchange(T const desired)
+		{
+		#if defined(__CUDACC__)
+			__threadfence();
+			word const old = atomicExch(reinterpret_cast<word*>(&value), cudlb::bit_cast<word>(desired));
+			__threadfence();
+			return cudlb::bit_cast<T>(old);
+		#else
+			return value.exchange(desired, std::memory_order_acq_rel);
+		#endif
+		}
+
+		/**
+		*	Adds @arg to the current value and returns the previous value.
+		*	NOTE: Only available for unsigned integral types.
+		*/
+		__device__
+		T fetch_add(T const arg)
+		{
+		#if defined(__CUDACC__)
+			__threadfence();
+			T const old = atomicAdd(&value, arg);
+			__threadfence();
+			return old;
+		#else
+			return value.fetch_add(arg, std::memory_order_acq_rel);
+		#endif
+		}
+
+		/**
+		*	Sets the bits of @arg in the current value and returns the previous value.
+		*	NOTE: Only available for unsigned integral types.
+		*/
+		__device__
+		T fetch_or(T const arg)
+		{
+		#if defined(__CUDACC__)
+			__threadfence();
+			T const old = atomicOr(&value, arg);
+			__threadfence();
+			return old;
+		#else
+			return value.fetch_or(arg, std::memory_order_acq_rel);
+		#endif
+		}
+
+	private:
+	#if defined(__CUDACC__)
+		alignas(sizeof(T)) T value;
+	#else
+		alignas(sizeof(T)) std::atomic<T> value;
+	#endif
+	};
+}
\ No newline at end of file
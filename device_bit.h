@@ -0,0 +1,109 @@
+#pragma once
+#include "device_config.h"
+#if !defined(__CUDA_ARCH__) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace cudlb
+{
+	/**
+	*	Counts the number of consecutive zero bits, starting from the least significant bit.
+	*	@x - value to inspect.
+	*	Returns 64 if @x is zero.
+	*/
+	__host__ __device__
+	inline int countr_zero(unsigned long long x)
+	{
+		if (x == 0) return 64;
+	#if defined(__CUDA_ARCH__)
+		return __ffsll(static_cast<long long>(x)) - 1;
+	#elif defined(_MSC_VER)
+		unsigned long index;
+		_BitScanForward64(&index, x);
+		return static_cast<int>(index);
+	#else
+		return __builtin_ctzll(x);
+	#endif
+	}
+
+	/**
+	*	Counts the number of consecutive zero bits, starting from the most significant bit.
+	*	@x - value to inspect.
+	*	Returns 64 if @x is zero.
+	*/
+	__host__ __device__
+	inline int countl_zero(unsigned long long x)
+	{
+		if (x == 0) return 64;
+	#if defined(__CUDA_ARCH__)
+		return __clzll(static_cast<long long>(x));
+	#elif defined(_MSC_VER)
+		unsigned long index;
+		_BitScanReverse64(&index, x);
+		return 63 - static_cast<int>(index);
+	#else
+		return __builtin_clzll(x);
+	#endif
+	}
+
+	/**
+	*	Returns the smallest power of two which is NOT LESS than @x.
+	*	@x - value to round up, must not exceed 2^63.
+	*/
+	__host__ __device__
+	inline unsigned long long bit_ceil(unsigned long long x)
+	{
+		if (x <= 1) return 1;
+		return 1ULL << (64 - cudlb::countl_zero(x - 1));
+	}
+
+	/**
+	*	Counts the number of consecutive one bits, starting from the least significant bit.
+	*	@x - value to inspect.
+	*/
+	__host__ __device__
+	inline int countr_one(unsigned long long x)
+	{
+		return cudlb::countr_zero(~x);
+	}
+
+	/**
+	*	Counts the number of one bits.
+	*	@x - value to inspect.
+	*/
+	__host__ __device__
+	inline int popcount(unsigned long long x)
+	{
+	#if defined(__CUDA_ARCH__)
+		return __popcll(x);
+	#elif defined(_MSC_VER)
+		return static_cast<int>(__popcnt64(x));
+	#else
+		return __builtin_popcountll(x);
+	#endif
+	}
+
+	/**
+	*	Returns the position of the one bit with index @n, counting one bits from the least significant bit.
+	*	@x - value to inspect.
+	*	@n - zero based index of the one bit to look for.
+	*	Returns 64 if @x has no more than @n one bits.
+	*/
+	__host__ __device__
+	inline int nth_set_bit(unsigned long long x, int n)
+	{
+		// Skip whole bytes by their population count, then clear the lowest one bits of the byte holding the result.
+		for (int shift = 0; shift != 64; shift += 8)
+		{
+			unsigned long long byte = (x >> shift) & 0xff;
+			int const c = cudlb::popcount(byte);
+			if (n < c)
+			{
+				for (; n != 0; --n) byte &= byte - 1;
+				return shift + cudlb::countr_zero(byte);
+			}
+			n -= c;
+		}
+		return 64;
+	}
+}
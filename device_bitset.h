@@ -0,0 +1,730 @@
+#pragma once
+#include "device_array.h"
+#include "device_allocator.h"
+#include "device_bit.h"
+#include "device_utility.h"
+#include "device_type_traits.h"
+
+namespace cudlb
+{
+	/**
+	*	Word level operations shared by device_bitset and device_dynamic_bitset.
+	*	Bits are stored in 64-bit words, bit i lives in word i / 64 at position i % 64.
+	*	Bits past the size in the last word are always kept zero, so counting and searching can work on whole words.
+	*/
+	struct bitset_words {
+		using word_type = unsigned long long;
+		using size_type = size_t;
+
+		static constexpr size_type word_bits = 64;
+
+		/**
+		*	Returned by find_first() and find_next() when there is no further set bit.
+		*/
+		static constexpr size_type npos = ~size_type(0);
+
+		__device__
+		static constexpr size_type words_for(size_type const bits)
+		{
+			return (bits + word_bits - 1) / word_bits;
+		}
+
+		/**
+		*	Returns the mask of the bits of the last word which are within a size of @bits.
+		*/
+		__device__
+		static constexpr word_type last_word_mask(size_type const bits)
+		{
+			return bits % word_bits == 0 ? ~word_type(0) : (word_type(1) << (bits % word_bits)) - 1;
+		}
+
+		__device__
+		static size_type count(word_type const* w, size_type const n)
+		{
+			size_type c = 0;
+			for (size_type i = 0; i != n; ++i)
+				c += static_cast<size_type>(cudlb::popcount(w[i]));
+			return c;
+		}
+
+		/**
+		*	Returns the position of the first set bit at or after @pos, or npos.
+		*/
+		__device__
+		static size_type find_from(word_type const* w, size_type const n, size_type const pos)
+		{
+			size_type i = pos / word_bits;
+			if (i >= n) return npos;
+			word_type x = w[i] & (~word_type(0) << (pos % word_bits));
+			while (x == 0)
+			{
+				if (++i == n) return npos;
+				x = w[i];
+			}
+			return i * word_bits + static_cast<size_type>(cudlb::countr_zero(x));
+		}
+
+		/**
+		*	Calls @f with the position of every set bit in ascending order, clearing the lowest set bit of a word per step.
+		*/
+		template<typename Function>
+		__device__
+		static void for_each_set(word_type const* w, size_type const n, Function f)
+		{
+			for (size_type i = 0; i != n; ++i)
+			{
+				for (word_type x = w[i]; x != 0; x &= x - 1)
+					f(i * word_bits + static_cast<size_type>(cudlb::countr_zero(x)));
+			}
+		}
+
+		__device__
+		static bool equal(word_type const* a, word_type const* b, size_type const n)
+		{
+			word_type diff = 0;
+			for (size_type i = 0; i != n; ++i)
+				diff |= a[i] ^ b[i];
+			return diff == 0;
+		}
+	};
+
+	/**
+	*	Fixed size sequence of N bits, stored in a device_array of 64-bit words.
+	*	Logical operations work on a whole word per step, counting uses popcount and searching count-trailing-zeros.
+	*/
+	template<size_t N>
+	class device_bitset {
+		static_assert(N > 0, "device_bitset requires at least one bit");
+	public:
+		using word_type = bitset_words::word_type;
+		using size_type = size_t;
+
+		static constexpr size_type npos = bitset_words::npos;
+
+		/**
+		*	Constructs a bitset with all bits cleared.
+		*/
+		__device__
+		device_bitset()
+		{
+			bits.fill(0);
+		}
+
+		__device__
+		bool test(size_type const pos) const
+		{
+			return (bits[pos / 64] >> (pos % 64)) & 1;
+		}
+
+		__device__
+		bool operator[](size_type const pos) const
+		{
+			return test(pos);
+		}
+
+		__device__
+		device_bitset& set(size_type const pos, bool const value = true)
+		{
+			word_type const m = word_type(1) << (pos % 64);
+			bits[pos / 64] = value ? (bits[pos / 64] | m) : (bits[pos / 64] & ~m);
+			return *this;
+		}
+
+		__device__
+		device_bitset& reset(size_type const pos)
+		{
+			return set(pos, false);
+		}
+
+		__device__
+		device_bitset& flip(size_type const pos)
+		{
+			bits[pos / 64] ^= word_type(1) << (pos % 64);
+			return *this;
+		}
+
+		/**
+		*	Sets all bits.
+		*/
+		__device__
+		device_bitset& set()
+		{
+			bits.fill(~word_type(0));
+			trim();
+			return *this;
+		}
+
+		/**
+		*	Clears all bits.
+		*/
+		__device__
+		device_bitset& reset()
+		{
+			bits.fill(0);
+			return *this;
+		}
+
+		/**
+		*	Flips all bits.
+		*/
+		__device__
+		device_bitset& flip()
+		{
+			for (size_type i = 0; i != word_count(); ++i)
+				bits[i] = ~bits[i];
+			trim();
+			return *this;
+		}
+
+		__device__
+		device_bitset& operator&=(device_bitset const& other)
+		{
+			for (size_type i = 0; i != word_count(); ++i)
+				bits[i] &= other.bits[i];
+			return *this;
+		}
+
+		__device__
+		device_bitset& operator|=(device_bitset const& other)
+		{
+			for (size_type i = 0; i != word_count(); ++i)
+				bits[i] |= other.bits[i];
+			return *this;
+		}
+
+		__device__
+		device_bitset& operator^=(device_bitset const& other)
+		{
+			for (size_type i = 0; i != word_count(); ++i)
+				bits[i] ^= other.bits[i];
+			return *this;
+		}
+
+		/**
+		*	Clears every bit which is set in @other.
+		*/
+		__device__
+		device_bitset& and_not(device_bitset const& other)
+		{
+			for (size_type i = 0; i != word_count(); ++i)
+				bits[i] &= ~other.bits[i];
+			return *this;
+		}
+
+		/**
+		*	Returns the number of set bits.
+		*/
+		__device__
+		size_type count() const
+		{
+			return bitset_words::count(words(), word_count());
+		}
+
+		__device__
+		bool any() const
+		{
+			return find_first() != npos;
+		}
+
+		__device__
+		bool none() const
+		{
+			return !any();
+		}
+
+		__device__
+		bool all() const
+		{
+			return count() == N;
+		}
+
+		/**
+		*	Returns the position of the first set bit, or npos if no bit is set.
+		*/
+		__device__
+		size_type find_first() const
+		{
+			return bitset_words::find_from(words(), word_count(), 0);
+		}
+
+		/**
+		*	Returns the position of the first set bit after @pos, or npos if there is none.
+		*/
+		__device__
+		size_type find_next(size_type const pos) const
+		{
+			return pos + 1 >= N ? npos : bitset_words::find_from(words(), word_count(), pos + 1);
+		}
+
+		/**
+		*	Calls @f with the position of every set bit in ascending order.
+		*	NOTE: Faster than a find_first() and find_next() loop, which restarts the word scan for every bit.
+		*/
+		template<typename Function>
+		__device__
+		void for_each_set(Function f) const
+		{
+			bitset_words::for_each_set(words(), word_count(), f);
+		}
+
+		/**
+		*	Returns the number of bits.
+		*/
+		__device__
+		constexpr size_type size() const
+		{
+			return N;
+		}
+
+		/**
+		*	Returns the number of 64-bit words the bits are stored in.
+		*/
+		__device__
+		constexpr size_type word_count() const
+		{
+			return bitset_words::words_for(N);
+		}
+
+		/**
+		*	Returns the words the bits are stored in, bits past size() in the last word are zero.
+		*/
+		__device__
+		word_type const* words() const
+		{
+			return &bits[0];
+		}
+
+		__device__
+		bool operator==(device_bitset const& other) const
+		{
+			return bitset_words::equal(words(), other.words(), word_count());
+		}
+
+		__device__
+		bool operator!=(device_bitset const& other) const
+		{
+			return !(*this == other);
+		}
+
+	private:
+		/**
+		*	Clears the bits of the last word past size().
+		*/
+		__device__
+		void trim()
+		{
+			bits[word_count() - 1] &= bitset_words::last_word_mask(N);
+		}
+
+		cudlb::device_array<word_type, (N + 63) / 64> bits;
+	};
+
+	template<size_t N>
+	__device__
+	device_bitset<N> operator&(device_bitset<N> lhs, device_bitset<N> const& rhs)
+	{
+		return lhs &= rhs;
+	}
+
+	template<size_t N>
+	__device__
+	device_bitset<N> operator|(device_bitset<N> lhs, device_bitset<N> const& rhs)
+	{
+		return lhs |= rhs;
+	}
+
+	template<size_t N>
+	__device__
+	device_bitset<N> operator^(device_bitset<N> lhs, device_bitset<N> const& rhs)
+	{
+		return lhs ^= rhs;
+	}
+
+	/**
+	*	Sequence of bits with a size chosen at run time, stored in 64-bit words obtained from the allocator.
+	*	Binary operations require both bitsets to have the same size.
+	*/
+	template<typename Allocator = cudlb::device_allocator<unsigned long long>>
+	class device_dynamic_bitset {
+	public:
+		using word_type = bitset_words::word_type;
+		using size_type = size_t;
+		using allocator = typename Allocator::template rebind<word_type>::other;
+
+		static constexpr size_type npos = bitset_words::npos;
+
+		/**
+		*	Constructs a bitset of @n bits, all set to @value.
+		*	@n - number of bits.
+		*	@value - initial value of the bits.
+		*	@a - user specified allocator object.
+		*/
+		__device__
+		explicit device_dynamic_bitset(size_type const n, bool const value = false, Allocator const& a = Allocator())
+			: alloc{ a }, bits{ nullptr }, nbits{ n }
+		{
+			bits = alloc.allocate(word_count());
+			for (size_type i = 0; i != word_count(); ++i)
+				bits[i] = value ? ~word_type(0) : 0;
+			trim();
+		}
+
+		__device__
+		device_dynamic_bitset(device_dynamic_bitset const& other)
+			: alloc{ other.alloc }, bits{ nullptr }, nbits{ other.nbits }
+		{
+			bits = alloc.allocate(word_count());
+			for (size_type i = 0; i != word_count(); ++i)
+				bits[i] = other.bits[i];
+		}
+
+		__device__
+		~device_dynamic_bitset()
+		{
+			alloc.deallocate(bits, word_count());
+		}
+
+		device_dynamic_bitset const& operator=(device_dynamic_bitset const&) = delete;
+
+		__device__
+		bool test(size_type const pos) const
+		{
+			return (bits[pos / 64] >> (pos % 64)) & 1;
+		}
+
+		__device__
+		bool operator[](size_type const pos) const
+		{
+			return test(pos);
+		}
+
+		__device__
+		device_dynamic_bitset& set(size_type const pos, bool const value = true)
+		{
+			word_type const m = word_type(1) << (pos % 64);
+			bits[pos / 64] = value ? (bits[pos / 64] | m) : (bits[pos / 64] & ~m);
+			return *this;
+		}
+
+		__device__
+		device_dynamic_bitset& reset(size_type const pos)
+		{
+			return set(pos, false);
+		}
+
+		__device__
+		device_dynamic_bitset& flip(size_type const pos)
+		{
+			bits[pos / 64] ^= word_type(1) << (pos % 64);
+			return *this;
+		}
+
+		/**
+		*	Sets all bits.
+		*/
+		__device__
+		device_dynamic_bitset& set()
+		{
+			for (size_type i = 0; i != word_count(); ++i)
+				bits[i] = ~word_type(0);
+			trim();
+			return *this;
+		}
+
+		/**
+		*	Clears all bits.
+		*/
+		__device__
+		device_dynamic_bitset& reset()
+		{
+			for (size_type i = 0; i != word_count(); ++i)
+				bits[i] = 0;
+			return *this;
+		}
+
+		/**
+		*	Flips all bits.
+		*/
+		__device__
+		device_dynamic_bitset& flip()
+		{
+			for (size_type i = 0; i != word_count(); ++i)
+				bits[i] = ~bits[i];
+			trim();
+			return *this;
+		}
+
+		__device__
+		device_dynamic_bitset& operator&=(device_dynamic_bitset const& other)
+		{
+			for (size_type i = 0; i != word_count(); ++i)
+				bits[i] &= other.bits[i];
+			return *this;
+		}
+
+		__device__
+		device_dynamic_bitset& operator|=(device_dynamic_bitset const& other)
+		{
+			for (size_type i = 0; i != word_count(); ++i)
+				bits[i] |= other.bits[i];
+			return *this;
+		}
+
+		__device__
+		device_dynamic_bitset& operator^=(device_dynamic_bitset const& other)
+		{
+			for (size_type i = 0; i != word_count(); ++i)
+				bits[i] ^= other.bits[i];
+			return *this;
+		}
+
+		/**
+		*	Clears every bit which is set in @other.
+		*/
+		__device__
+		device_dynamic_bitset& and_not(device_dynamic_bitset const& other)
+		{
+			for (size_type i = 0; i != word_count(); ++i)
+				bits[i] &= ~other.bits[i];
+			return *this;
+		}
+
+		/**
+		*	Returns the number of set bits.
+		*/
+		__device__
+		size_type count() const
+		{
+			return bitset_words::count(bits, word_count());
+		}
+
+		__device__
+		bool any() const
+		{
+			return find_first() != npos;
+		}
+
+		__device__
+		bool none() const
+		{
+			return !any();
+		}
+
+		__device__
+		bool all() const
+		{
+			return count() == nbits;
+		}
+
+		/**
+		*	Returns the position of the first set bit, or npos if no bit is set.
+		*/
+		__device__
+		size_type find_first() const
+		{
+			return bitset_words::find_from(bits, word_count(), 0);
+		}
+
+		/**
+		*	Returns the position of the first set bit after @pos, or npos if there is none.
+		*/
+		__device__
+		size_type find_next(size_type const pos) const
+		{
+			return pos + 1 >= nbits ? npos : bitset_words::find_from(bits, word_count(), pos + 1);
+		}
+
+		/**
+		*	Calls @f with the position of every set bit in ascending order.
+		*	NOTE: Faster than a find_first() and find_next() loop, which restarts the word scan for every bit.
+		*/
+		template<typename Function>
+		__device__
+		void for_each_set(Function f) const
+		{
+			bitset_words::for_each_set(bits, word_count(), f);
+		}
+
+		/**
+		*	Returns the number of bits.
+		*/
+		__device__
+		size_type size() const
+		{
+			return nbits;
+		}
+
+		/**
+		*	Returns the number of 64-bit words the bits are stored in.
+		*/
+		__device__
+		size_type word_count() const
+		{
+			return bitset_words::words_for(nbits);
+		}
+
+		/**
+		*	Returns the words the bits are stored in, bits past size() in the last word are zero.
+		*/
+		__device__
+		word_type const* words() const
+		{
+			return bits;
+		}
+
+		__device__
+		bool operator==(device_dynamic_bitset const& other) const
+		{
+			return nbits == other.nbits && bitset_words::equal(bits, other.bits, word_count());
+		}
+
+		__device__
+		bool operator!=(device_dynamic_bitset const& other) const
+		{
+			return !(*this == other);
+		}
+
+	private:
+		/**
+		*	Clears the bits of the last word past size().
+		*/
+		__device__
+		void trim()
+		{
+			if (word_count() != 0) bits[word_count() - 1] &= bitset_words::last_word_mask(nbits);
+		}
+
+		allocator alloc;
+		word_type* bits;
+		size_type nbits;
+	};
+
+	/**
+	*	Rank and select index over the words of a device_bitset or device_dynamic_bitset.
+	*	The number of set bits before every 512-bit block is sampled, so rank() reads one sample and popcounts
+	*	at most 8 words, and select() binary searches the samples and scans at most 8 words.
+	*	NOTE: The index refers to the words of the bitset it was built from, it has to be rebuilt after the bitset changes
+	*	and must not outlive it.
+	*/
+	template<typename Allocator = cudlb::device_allocator<size_t>>
+	class device_rank_index {
+	public:
+		using word_type = bitset_words::word_type;
+		using size_type = size_t;
+		using allocator = typename Allocator::template rebind<size_type>::other;
+
+		/**
+		*	Number of bits per sample.
+		*/
+		static constexpr size_type sample_bits = 512;
+
+		/**
+		*	Builds the index of a bitset.
+		*	@b - bitset to index.
+		*	@a - user specified allocator object.
+		*/
+		template<typename Bitset>
+		__device__
+		explicit device_rank_index(Bitset const& b, Allocator const& a = Allocator())
+			: alloc{ a }, words{ nullptr }, nbits{ 0 }, samples{ nullptr }, nsamples{ 0 }
+		{
+			rebuild(b);
+		}
+
+		__device__
+		~device_rank_index()
+		{
+			alloc.deallocate(samples, nsamples);
+		}
+
+		device_rank_index(device_rank_index const&) = delete;
+
+		device_rank_index const& operator=(device_rank_index const&) = delete;
+
+		/**
+		*	Recomputes the samples, after the bitset changed or to index another bitset.
+		*	@b - bitset to index.
+		*/
+		template<typename Bitset>
+		__device__
+		void rebuild(Bitset const& b)
+		{
+			alloc.deallocate(samples, nsamples);
+			words = b.words();
+			nbits = b.size();
+			size_type const nwords = b.word_count();
+			// One sample per block plus the total, so select() can binary search without a bounds check.
+			nsamples = nwords / words_per_sample + 2;
+			samples = alloc.allocate(nsamples);
+			size_type total = 0;
+			for (size_type s = 0; s != nsamples; ++s)
+			{
+				samples[s] = total;
+				size_type const end = (s + 1) * words_per_sample < nwords ? (s + 1) * words_per_sample : nwords;
+				for (size_type i = s * words_per_sample; i < end; ++i)
+					total += static_cast<size_type>(cudlb::popcount(words[i]));
+			}
+		}
+
+		/**
+		*	Returns the number of set bits before position @pos.
+		*	@pos - position, at most the size of the bitset.
+		*/
+		__device__
+		size_type rank(size_type const pos) const
+		{
+			size_type const w = pos / 64;
+			size_type r = samples[w / words_per_sample];
+			for (size_type i = w - w % words_per_sample; i != w; ++i)
+				r += static_cast<size_type>(cudlb::popcount(words[i]));
+			if (pos % 64 != 0)
+				r += static_cast<size_type>(cudlb::popcount(words[w] & ((word_type(1) << (pos % 64)) - 1)));
+			return r;
+		}
+
+		/**
+		*	Returns the position of the set bit with index @n, counting set bits from position 0.
+		*	@n - zero based index of the set bit to look for.
+		*	Returns the size of the bitset if it has no more than @n set bits.
+		*/
+		__device__
+		size_type select(size_type n) const
+		{
+			if (n >= count()) return nbits;
+			// Last sample NOT GREATER than n, the samples never decrease.
+			size_type lo = 0;
+			size_type hi = nsamples - 1;
+			while (hi - lo > 1)
+			{
+				size_type const mid = lo + (hi - lo) / 2;
+				if (samples[mid] <= n) lo = mid;
+				else hi = mid;
+			}
+			n -= samples[lo];
+			for (size_type i = lo * words_per_sample; ; ++i)
+			{
+				size_type const c = static_cast<size_type>(cudlb::popcount(words[i]));
+				if (n < c) return i * 64 + static_cast<size_type>(cudlb::nth_set_bit(words[i], static_cast<int>(n)));
+				n -= c;
+			}
+		}
+
+		/**
+		*	Returns the number of set bits in the indexed bitset.
+		*/
+		__device__
+		size_type count() const
+		{
+			return samples[nsamples - 1];
+		}
+
+	private:
+		static constexpr size_type words_per_sample = sample_bits / 64;
+
+		allocator alloc;
+		word_type const* words;
+		size_type nbits;
+		size_type* samples;	// Number of set bits before each 512-bit block, the last entry is the total.
+		size_type nsamples;
+	};
+}
@@ -0,0 +1,284 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include "device_allocator.h"
+#include "device_atomic.h"
+#include "device_utility.h"
+#include "device_type_traits.h"
+#include "device_hash.h"
+
+namespace cudlb
+{
+	/**
+	*	Blocked Bloom filter, answers "definitely not present" or "possibly present" for keys of type T.
+	*	Every key maps to a single block of BlockWords 64-bit words, 256 or 512 bits aligned to a cache line boundary,
+	*	so that an insertion or a lookup touches one cache line however many bits it sets or tests.
+	*	The high half of the key's hash selects the block and the low half is multiplied by a fixed odd salt per bit,
+	*	giving k bit positions which are gathered into one mask per word and tested with a single AND per word.
+	*	Inserts set the words with an atomic OR, so many threads can build a filter at the same time.
+	*	NOTE: Keys cannot be removed. Blocking costs some accuracy, the false positive rate reached is slightly above
+	*	the one requested from the constructor.
+	*/
+	template<typename T, typename Hash = cudlb::hash<T>, typename Allocator = cudlb::device_allocator<T>, size_t BlockWords = 4>
+	class device_bloom_filter {
+		static_assert(BlockWords == 4 || BlockWords == 8, "device_bloom_filter blocks must be 256 or 512 bits wide");
+	public:
+		using value_type = T;
+		using size_type = size_t;
+		using hasher = Hash;
+		using allocator = Allocator;
+
+		static constexpr size_type block_words = BlockWords;
+		static constexpr size_type block_bits = 64 * BlockWords;
+		static constexpr unsigned int max_hash_count = 16;
+
+		/**
+		*	Constructs an empty filter sized for a number of keys and a target false positive rate.
+		*	@n - expected number of keys.
+		*	@fpr - target false positive rate, in the range (0 : 1).
+		*	@h - hash function object.
+		*	@a - user specified allocator object.
+		*/
+		__device__
+		device_bloom_filter(size_type const n, double const fpr = 0.01, Hash const& h = Hash(), Allocator const& a = Allocator())
+			: hash{ h }, alloc{ a }, raw{ nullptr }, words{ nullptr }, blocks{ 0 }, k{ 0 }
+		{
+			// Optimal bits per key is -ln(p) / ln(2)^2 with ln(2) * bits per key hash functions.
+			double const ln2 = 0.6931471805599453;
+			double const p = (fpr > 0.0 && fpr < 1.0) ? fpr : 0.01;
+			double const bits_per_key = -::log(p) / (ln2 * ln2);
+			double const hashes = bits_per_key * ln2 + 0.5;
+			k = hashes < 1.0 ? 1 : (hashes > max_hash_count ? max_hash_count : static_cast<unsigned int>(hashes));
+			size_type const bits = static_cast<size_type>(static_cast<double>(n) * bits_per_key) + 1;
+			blocks = (bits + block_bits - 1) / block_bits;
+			allocate_space();
+		}
+
+		__device__
+		~device_bloom_filter()
+		{
+			deallocate_space();
+		}
+
+		device_bloom_filter(device_bloom_filter const&) = delete;
+
+		device_bloom_filter const& operator=(device_bloom_filter const&) = delete;
+
+		/**
+		*	Adds a key to the filter. Safe to call from many threads at once.
+		*	@key - key to add.
+		*/
+		__device__
+		void insert(T const& key)
+		{
+			insert_hashed(static_cast<unsigned long long>(hash(key)));
+		}
+
+		/**
+		*	Adds all keys of a range to the filter.
+		*	@first - iterator to the first key.
+		*	@last - iterator past the last key.
+		*	NOTE: Keys are hashed a group at a time and their blocks prefetched before any of them is written.
+		*/
+		template<typename Iterator>
+		__device__
+		void insert_range(Iterator first, Iterator last)
+		{
+			unsigned long long h[group_size];
+			while (first != last)
+			{
+				size_type const n = hash_group(first, last, h);
+				for (size_type i = 0; i != n; ++i)
+					insert_hashed(h[i]);
+			}
+		}
+
+		/**
+		*	Checks if a key may have been added to the filter.
+		*	@key - key to look for.
+		*	Returns false if the key was definitely never added.
+		*/
+		__device__
+		bool contains(T const& key) const
+		{
+			return contains_hashed(static_cast<unsigned long long>(hash(key)));
+		}
+
+		/**
+		*	Checks a range of keys, writing one result per key.
+		*	@first - iterator to the first key.
+		*	@last - iterator past the last key.
+		*	@out - iterator to the first of (last - first) results, each true if the key may have been added.
+		*	Returns an iterator past the last result written.
+		*	NOTE: Keys are hashed a group at a time and their blocks prefetched before any of them is tested.
+		*/
+		template<typename Iterator, typename OutputIterator>
+		__device__
+		OutputIterator contains_batch(Iterator first, Iterator last, OutputIterator out) const
+		{
+			unsigned long long h[group_size];
+			while (first != last)
+			{
+				size_type const n = hash_group(first, last, h);
+				for (size_type i = 0; i != n; ++i, ++out)
+					*out = contains_hashed(h[i]);
+			}
+			return out;
+		}
+
+		/**
+		*	Removes all keys.
+		*	NOTE: Not safe to call concurrently with other operations.
+		*/
+		__device__
+		void clear()
+		{
+			for (size_type i = 0; i != blocks * BlockWords; ++i)
+				words[i].store(0);
+		}
+
+		/**
+		*	Returns the number of blocks.
+		*/
+		__device__
+		size_type block_count() const
+		{
+			return blocks;
+		}
+
+		/**
+		*	Returns the number of bits set or tested per key.
+		*/
+		__device__
+		unsigned int hash_count() const
+		{
+			return k;
+		}
+
+		/**
+		*	Returns the size of the filter in bits.
+		*/
+		__device__
+		size_type size_in_bits() const
+		{
+			return blocks * block_bits;
+		}
+
+	private:
+		using word_allocator = typename Allocator::template rebind<cudlb::atomic<unsigned long long>>::other;
+
+		/**
+		*	Number of keys hashed and prefetched ahead by the range operations.
+		*/
+		static constexpr size_type group_size = 8;
+
+		static constexpr size_type block_bytes = 8 * BlockWords;
+		// Number of bits of a position within a block.
+		static constexpr unsigned int position_bits = BlockWords == 4 ? 8 : 9;
+
+		/**
+		*	Returns the first word of the block selected by the high half of @h.
+		*/
+		__device__
+		cudlb::atomic<unsigned long long>* block_of(unsigned long long const h) const
+		{
+			unsigned long long const b = ((h >> 32) * static_cast<unsigned long long>(blocks)) >> 32;
+			return words + b * BlockWords;
+		}
+
+		/**
+		*	Collects the k bit positions of the low half of @h into one mask per word of a block.
+		*/
+		__device__
+		void make_masks(unsigned long long const h, unsigned long long (&mask)[BlockWords]) const
+		{
+			// Odd multipliers, each spreading the low hash bits differently over the top position_bits of a 32-bit product.
+			unsigned int const salt[max_hash_count] = {
+				0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU, 0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U,
+				0x9e3779b1U, 0x85ebca77U, 0xc2b2ae3dU, 0x27d4eb2fU, 0x165667b1U, 0xd3a2646dU, 0xfd7046c5U, 0xb55a4f09U
+			};
+			unsigned int const low = static_cast<unsigned int>(h);
+			for (size_type w = 0; w != BlockWords; ++w)
+				mask[w] = 0;
+			for (unsigned int i = 0; i != k; ++i)
+			{
+				unsigned int const position = (low * salt[i]) >> (32 - position_bits);
+				mask[position >> 6] |= 1ULL << (position & 63);
+			}
+		}
+
+		__device__
+		void insert_hashed(unsigned long long const h)
+		{
+			unsigned long long mask[BlockWords];
+			make_masks(h, mask);
+			cudlb::atomic<unsigned long long>* const block = block_of(h);
+			for (size_type w = 0; w != BlockWords; ++w)
+			{
+				if (mask[w] != 0) block[w].fetch_or(mask[w]);
+			}
+		}
+
+		__device__
+		bool contains_hashed(unsigned long long const h) const
+		{
+			unsigned long long mask[BlockWords];
+			make_masks(h, mask);
+			cudlb::atomic<unsigned long long> const* const block = block_of(h);
+			unsigned long long missing = 0;
+			for (size_type w = 0; w != BlockWords; ++w)
+				missing |= mask[w] & ~block[w].load();
+			return missing == 0;
+		}
+
+		/**
+		*	Hashes up to group_size keys from @first, advancing it, and prefetches their blocks.
+		*	Returns the number of keys hashed.
+		*/
+		template<typename Iterator>
+		__device__
+		size_type hash_group(Iterator& first, Iterator const& last, unsigned long long (&h)[group_size]) const
+		{
+			size_type n = 0;
+			for (; n != group_size && first != last; ++n, ++first)
+			{
+				h[n] = static_cast<unsigned long long>(hash(*first));
+				cudlb::prefetch(block_of(h[n]));
+			}
+			return n;
+		}
+
+		/**
+		*	Allocates the blocks with all bits cleared, aligned to block_bytes.
+		*	NOTE: One extra block is allocated, the allocator only guarantees the alignment of fundamental types.
+		*/
+		__device__
+		void allocate_space()
+		{
+			size_type const total = (blocks + 1) * BlockWords;
+			raw = alloc.allocate(total);
+			for (size_type i = 0; i != total; ++i)
+				alloc.construct(raw + i, 0ULL);
+			uintptr_t const address = reinterpret_cast<uintptr_t>(raw);
+			size_type const offset = static_cast<size_type>((block_bytes - (address & (block_bytes - 1))) & (block_bytes - 1));
+			words = raw + offset / sizeof(unsigned long long);
+		}
+
+		__device__
+		void deallocate_space()
+		{
+			size_type const total = (blocks + 1) * BlockWords;
+			for (size_type i = 0; i != total; ++i)
+				alloc.destroy(raw + i);
+			alloc.deallocate(raw, total);
+			raw = words = nullptr;
+		}
+
+		Hash hash;
+		word_allocator alloc;
+		cudlb::atomic<unsigned long long>* raw;		// Start of the allocation.
+		cudlb::atomic<unsigned long long>* words;	// First word of the first aligned block.
+		size_type blocks;
+		unsigned int k;		// Number of bits set per key.
+	};
+}
@@ -0,0 +1,310 @@
+#pragma once
+#include "device_allocator.h"
+#include "device_atomic.h"
+#include "device_bit.h"
+#include "device_utility.h"
+#include "device_type_traits.h"
+#include "device_hash.h"
+
+namespace cudlb
+{
+	/**
+	*	Fixed capacity hash map which many threads can insert into and search at the same time.
+	*	Slots are claimed with a compare-and-swap on the key, probing is linear and nothing is ever erased.
+	*	If both Key and T are 4 bytes wide, a key and its value share one 64-bit word which is written with a single
+	*	compare-and-swap, so a reader always sees a key together with its value. Otherwise keys and values live in
+	*	separate arrays and the value is stored atomically right after its key has been claimed.
+	*	@empty_key - key value reserved to mark empty slots, it can never be inserted.
+	*	@empty_value - value the slots start with.
+	*	NOTE: Keys are compared by their object representation. Key and T must be 4 or 8 bytes wide, wider values
+	*	could not be read and written in one atomic step, so a concurrent find() could see half of an update.
+	*	find() is wait-free, it never retries and stops after at most capacity() probes.
+	*/
+	template<typename Key, typename T, typename Hash = cudlb::hash<Key>, typename Allocator = cudlb::device_allocator<Key>>
+	class device_concurrent_unordered_map {
+	public:
+		using key_type = Key;
+		using mapped_type = T;
+		using size_type = size_t;
+		using hasher = Hash;
+		using allocator = Allocator;
+		using packed = cudlb::integral_constant<bool, sizeof(Key) == 4 && sizeof(T) == 4>;
+
+		static_assert(sizeof(Key) == 4 || sizeof(Key) == 8, "cudlb::device_concurrent_unordered_map requires 4 or 8 byte keys");
+		static_assert(sizeof(T) == 4 || sizeof(T) == 8, "cudlb::device_concurrent_unordered_map requires 4 or 8 byte values");
+
+		/**
+		*	Constructs an empty map.
+		*	@n - number of slots, rounded up to a power of two. Keep it well above the number of keys, probe runs grow quickly past 70% load.
+		*	@empty_key - key value reserved to mark empty slots.
+		*	@empty_value - value the slots start with.
+		*	@h - hash function object.
+		*	@a - user specified allocator object.
+		*/
+		__device__
+		device_concurrent_unordered_map(size_type const n, Key const& empty_key, T const& empty_value, Hash const& h = Hash(), Allocator const& a = Allocator())
+			: hash{ h }, palloc{ a }, kalloc{ a }, valloc{ a }, pairs{ nullptr }, keys{ nullptr }, values{ nullptr },
+			slots{ static_cast<size_type>(cudlb::bit_ceil(n)) }, empty_key{ empty_key }, empty_value{ empty_value }
+		{
+			allocate_space(packed());
+		}
+
+		__device__
+		~device_concurrent_unordered_map()
+		{
+			deallocate_space(packed());
+		}
+
+		device_concurrent_unordered_map(device_concurrent_unordered_map const&) = delete;
+
+		device_concurrent_unordered_map const& operator=(device_concurrent_unordered_map const&) = delete;
+
+		/**
+		*	Inserts a key and its value, if the key is not in the map yet. Safe to call from many threads at once.
+		*	@key - key to insert, must not be equal to the empty key.
+		*	@val - value of the key.
+		*	Returns true if the key was inserted, false if it was already present or the map is full.
+		*/
+		__device__
+		bool insert(Key const& key, T const& val)
+		{
+			return insert(key, val, false, packed());
+		}
+
+		/**
+		*	Inserts a key and its value, or replaces the value if the key is already present. Safe to call from many threads at once.
+		*	@key - key to insert, must not be equal to the empty key.
+		*	@val - new value of the key.
+		*	Returns true if the key was inserted, false if it was already present or the map is full.
+		*/
+		__device__
+		bool insert_or_assign(Key const& key, T const& val)
+		{
+			return insert(key, val, true, packed());
+		}
+
+		/**
+		*	Looks for @key and copies its value to @out. Safe to call concurrently with insertions.
+		*	@key - key to look for.
+		*	@out - receives the value of the key if it was found.
+		*	Returns true if the key was found.
+		*	NOTE: Without packing, a key found while its insertion is still in flight may report the empty value.
+		*/
+		__device__
+		bool find(Key const& key, T& out) const
+		{
+			return find(key, out, packed());
+		}
+
+		/**
+		*	Checks if the map holds @key. Safe to call concurrently with insertions.
+		*	@key - key to look for.
+		*/
+		__device__
+		bool contains(Key const& key) const
+		{
+			T out = empty_value;
+			return find(key, out, packed());
+		}
+
+		/**
+		*	Returns the number of keys in the map.
+		*	NOTE: Scans all slots, the result is only exact while no insertions are running.
+		*/
+		__device__
+		size_type size() const
+		{
+			size_type n = 0;
+			for (size_type i = 0; i != slots; ++i)
+			{
+				if (!is_empty(slot_key(i, packed()))) ++n;
+			}
+			return n;
+		}
+
+		/**
+		*	Returns the number of slots, the most keys the map can hold.
+		*/
+		__device__
+		size_type capacity() const
+		{
+			return slots;
+		}
+
+	private:
+		using pair_word = unsigned long long;
+		using key_word = typename cudlb::atomic_word<sizeof(Key)>::type;
+		using value_slot = cudlb::atomic<T>;
+		using pair_allocator = typename Allocator::template rebind<cudlb::atomic<pair_word>>::other;
+		using key_allocator = typename Allocator::template rebind<cudlb::atomic<Key>>::other;
+		using value_allocator = typename Allocator::template rebind<value_slot>::other;
+
+		/**
+		*	Packs a key into the low and a value into the high half of a 64-bit word.
+		*/
+		__device__
+		static pair_word make_pair_word(Key const& key, T const& val)
+		{
+			return static_cast<pair_word>(cudlb::bit_cast<unsigned int>(key)) | (static_cast<pair_word>(cudlb::bit_cast<unsigned int>(val)) << 32);
+		}
+
+		__device__
+		bool is_empty(key_word const k) const
+		{
+			return k == cudlb::bit_cast<key_word>(empty_key);
+		}
+
+		__device__
+		key_word slot_key(size_type const i, cudlb::true_type) const
+		{
+			return static_cast<key_word>(pairs[i].load());
+		}
+
+		__device__
+		key_word slot_key(size_type const i, cudlb::false_type) const
+		{
+			return cudlb::bit_cast<key_word>(keys[i].load());
+		}
+
+		__device__
+		bool insert(Key const& key, T const& val, bool const assign, cudlb::true_type)
+		{
+			key_word const k = cudlb::bit_cast<key_word>(key);
+			pair_word const desired = make_pair_word(key, val);
+			size_type i = hash(key) & (slots - 1);
+			for (size_type probe = 0; probe != slots; ++probe, i = (i + 1) & (slots - 1))
+			{
+				pair_word current = pairs[i].load();
+				while (true)
+				{
+					key_word const current_key = static_cast<key_word>(current);
+					if (current_key == k)
+					{
+						if (!assign) return false;
+						if (pairs[i].compare_exchange(current, desired)) return false;
+					}
+					else if (is_empty(current_key))
+					{
+						if (pairs[i].compare_exchange(current, desired)) return true;
+					}
+					else
+					{
+						break;
+					}
+					// The slot changed under us, current now holds its new contents.
+				}
+			}
+			return false;
+		}
+
+		__device__
+		bool insert(Key const& key, T const& val, bool const assign, cudlb::false_type)
+		{
+			key_word const k = cudlb::bit_cast<key_word>(key);
+			size_type i = hash(key) & (slots - 1);
+			for (size_type probe = 0; probe != slots; ++probe, i = (i + 1) & (slots - 1))
+			{
+				Key current = keys[i].load();
+				if (is_empty(cudlb::bit_cast<key_word>(current)) && keys[i].compare_exchange(current, key))
+				{
+					values[i].store(val);
+					return true;
+				}
+				if (cudlb::bit_cast<key_word>(current) == k)
+				{
+					if (assign) values[i].store(val);
+					return false;
+				}
+			}
+			return false;
+		}
+
+		__device__
+		bool find(Key const& key, T& out, cudlb::true_type) const
+		{
+			key_word const k = cudlb::bit_cast<key_word>(key);
+			size_type i = hash(key) & (slots - 1);
+			for (size_type probe = 0; probe != slots; ++probe, i = (i + 1) & (slots - 1))
+			{
+				pair_word const current = pairs[i].load();
+				key_word const current_key = static_cast<key_word>(current);
+				if (current_key == k)
+				{
+					out = cudlb::bit_cast<T>(static_cast<unsigned int>(current >> 32));
+					return true;
+				}
+				if (is_empty(current_key)) return false;
+			}
+			return false;
+		}
+
+		__device__
+		bool find(Key const& key, T& out, cudlb::false_type) const
+		{
+			key_word const k = cudlb::bit_cast<key_word>(key);
+			size_type i = hash(key) & (slots - 1);
+			for (size_type probe = 0; probe != slots; ++probe, i = (i + 1) & (slots - 1))
+			{
+				key_word const current_key = cudlb::bit_cast<key_word>(keys[i].load());
+				if (current_key == k)
+				{
+					out = values[i].load();
+					return true;
+				}
+				if (is_empty(current_key)) return false;
+			}
+			return false;
+		}
+
+		__device__
+		void allocate_space(cudlb::true_type)
+		{
+			pairs = palloc.allocate(slots);
+			for (size_type i = 0; i != slots; ++i)
+				palloc.construct(pairs + i, make_pair_word(empty_key, empty_value));
+		}
+
+		__device__
+		void allocate_space(cudlb::false_type)
+		{
+			keys = kalloc.allocate(slots);
+			values = valloc.allocate(slots);
+			for (size_type i = 0; i != slots; ++i)
+			{
+				kalloc.construct(keys + i, empty_key);
+				valloc.construct(values + i, empty_value);
+			}
+		}
+
+		__device__
+		void deallocate_space(cudlb::true_type)
+		{
+			for (size_type i = 0; i != slots; ++i)
+				palloc.destroy(pairs + i);
+			palloc.deallocate(pairs, slots);
+		}
+
+		__device__
+		void deallocate_space(cudlb::false_type)
+		{
+			for (size_type i = 0; i != slots; ++i)
+			{
+				kalloc.destroy(keys + i);
+				valloc.destroy(values + i);
+			}
+			kalloc.deallocate(keys, slots);
+			valloc.deallocate(values, slots);
+		}
+
+		Hash hash;
+		pair_allocator palloc;
+		key_allocator kalloc;
+		value_allocator valloc;
+		cudlb::atomic<pair_word>* pairs;	// Packed key-value words, only used if packed is true.
+		cudlb::atomic<Key>* keys;			// Keys, only used if packed is false.
+		value_slot* values;					// Values, only used if packed is false.
+		size_type slots;
+		Key empty_key;
+		T empty_value;
+	};
+}
\ No newline at end of file
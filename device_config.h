@@ -0,0 +1,32 @@
+#pragma once
+
+/**
+*	Compilation environment.
+*	cudlb is written for nvcc, but the headers can also be compiled by a plain host compiler, which is how the
+*	containers and algorithms are tested and benchmarked on the CPU. In such host builds the CUDA execution space
+*	specifiers expand to nothing and device only code paths are replaced by their host equivalents.
+*/
+#if !defined(__CUDACC__)
+#	ifndef __host__
+#		define __host__
+#	endif
+#	ifndef __device__
+#		define __device__
+#	endif
+#	ifndef __forceinline__
+#		define __forceinline__ inline
+#	endif
+#endif
+
+/**
+*	Instruction sets available to the host code paths.
+*	CUDLB_SSE2 and CUDLB_AVX2 are defined when the host compiler targets them, device code never uses them.
+*/
+#if !defined(__CUDA_ARCH__)
+#	if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#		define CUDLB_SSE2
+#	endif
+#	if defined(__AVX2__)
+#		define CUDLB_AVX2
+#	endif
+#endif
@@ -0,0 +1,385 @@
+#pragma once
+#include <cstdint>
+#include "device_allocator.h"
+#include "device_bit.h"
+#include "device_utility.h"
+#include "device_type_traits.h"
+#include "device_hash.h"
+
+namespace cudlb
+{
+	/**
+	*	Unordered set with a bounded worst case lookup, implemented as a bucketized cuckoo hash table.
+	*	Every key has two candidate buckets of BucketSize slots, derived from the two halves of its hash,
+	*	and a bucket of 4 byte keys fills half a cache line with 8 slots. A lookup reads at most those two buckets,
+	*	plus a small stash which is only non-empty after an insertion failed to find a place.
+	*	Insertions that find both buckets full evict a key to its other bucket, for at most max_evictions steps.
+	*	@empty_key - key value reserved to mark empty slots, it can never be inserted.
+	*	NOTE: The table doubles its number of buckets only when the eviction chain and the stash are both exhausted.
+	*	Key must be trivially copyable, slots are written by assignment.
+	*/
+	template<typename Key, typename Hash = cudlb::hash<Key>, typename KeyEqual = cudlb::equal_to<Key>, typename Allocator = cudlb::device_allocator<Key>, size_t BucketSize = 8>
+	class device_cuckoo_set {
+	public:
+		using key_type = Key;
+		using value_type = Key;
+		using size_type = size_t;
+		using hasher = Hash;
+		using key_equal = KeyEqual;
+		using allocator = Allocator;
+
+		static constexpr size_type bucket_size = BucketSize;
+		static constexpr size_type stash_capacity = 8;
+		static constexpr size_type max_evictions = 256;
+
+		/**
+		*	Constructs an empty set with room for a user specified number of keys.
+		*	@n - number of keys the buckets should have slots for.
+		*	@empty_key - key value reserved to mark empty slots.
+		*	@h - hash function object.
+		*	@e - key equality function object.
+		*	@a - user specified allocator object.
+		*/
+		__device__
+		device_cuckoo_set(size_type const n, Key const& empty_key, Hash const& h = Hash(), KeyEqual const& e = KeyEqual(), Allocator const& a = Allocator())
+			: hash{ h }, equal{ e }, alloc{ a }, raw{ nullptr }, buckets{ nullptr }, mask{ 0 },
+			occupied{ 0 }, stash_size{ 0 }, empty_key{ empty_key }, seed{ 0x2545F4914F6CDD1DULL }
+		{
+			allocate_space(bucket_count_for(n));
+		}
+
+		__device__
+		~device_cuckoo_set()
+		{
+			deallocate_space();
+		}
+
+		device_cuckoo_set(device_cuckoo_set const&) = delete;
+
+		device_cuckoo_set const& operator=(device_cuckoo_set const&) = delete;
+
+		/**
+		*	Checks if the set holds a key equal to @key.
+		*	@key - key to look for.
+		*	NOTE: Reads at most two buckets and the stash, every slot of a bucket is compared without branching.
+		*/
+		__device__
+		bool contains(key_type const& key) const
+		{
+			size_type const h = hash(key);
+			if (in_bucket(buckets[first_bucket(h)], key) || in_bucket(buckets[second_bucket(h)], key))
+				return true;
+			for (size_type i = 0; i != stash_size; ++i)
+			{
+				if (equal(stash[i], key)) return true;
+			}
+			return false;
+		}
+
+		/**
+		*	Returns the number of keys equal to @key, either 0 or 1.
+		*	@key - key to look for.
+		*/
+		__device__
+		size_type count(key_type const& key) const
+		{
+			return contains(key) ? 1 : 0;
+		}
+
+		/**
+		*	Inserts a key, if it is not in the set yet.
+		*	@key - key to insert, must not be equal to the empty key.
+		*	Returns true if the key was inserted, false if it was already present.
+		*/
+		__device__
+		bool insert(key_type const& key)
+		{
+			if (contains(key)) return false;
+			Key pending = key;
+			if (!place(pending))
+			{
+				// Neither the eviction chain nor the stash had room, pending is the key left without a slot.
+				grow(pending);
+			}
+			++occupied;
+			return true;
+		}
+
+		/**
+		*	Removes the key equal to @key, if there is one.
+		*	@key - key to remove.
+		*	Returns the number of keys removed, either 0 or 1.
+		*/
+		__device__
+		size_type erase(key_type const& key)
+		{
+			size_type const h = hash(key);
+			if (erase_from(buckets[first_bucket(h)], key) || erase_from(buckets[second_bucket(h)], key))
+			{
+				--occupied;
+				return 1;
+			}
+			for (size_type i = 0; i != stash_size; ++i)
+			{
+				if (equal(stash[i], key))
+				{
+					stash[i] = stash[--stash_size];
+					--occupied;
+					return 1;
+				}
+			}
+			return 0;
+		}
+
+		/**
+		*	Removes all keys, the allocated space is kept.
+		*/
+		__device__
+		void clear()
+		{
+			for (size_type b = 0; b <= mask; ++b)
+			{
+				for (size_type s = 0; s != BucketSize; ++s)
+					buckets[b].keys[s] = empty_key;
+			}
+			stash_size = 0;
+			occupied = 0;
+		}
+
+		/**
+		*	Returns the number of keys in the set.
+		*/
+		__device__
+		size_type size() const
+		{
+			return occupied;
+		}
+
+		/**
+		*	Checks if the set holds no keys.
+		*/
+		__device__
+		bool empty() const
+		{
+			return occupied == 0;
+		}
+
+		/**
+		*	Returns the number of slots in all buckets.
+		*/
+		__device__
+		size_type capacity() const
+		{
+			return (mask + 1) * BucketSize;
+		}
+
+		/**
+		*	Returns the ratio of keys to slots.
+		*/
+		__device__
+		float load_factor() const
+		{
+			return static_cast<float>(occupied) / static_cast<float>(capacity());
+		}
+
+	private:
+		static constexpr size_type bucket_bytes = sizeof(Key) * BucketSize;
+		// Largest power of two dividing the bucket size, up to a cache line, so that no bucket straddles two lines.
+		static constexpr size_type bucket_alignment = (bucket_bytes & (~bucket_bytes + 1)) < 64 ? (bucket_bytes & (~bucket_bytes + 1)) : 64;
+
+		struct alignas(bucket_alignment) bucket {
+			Key keys[BucketSize];
+		};
+
+		using bucket_allocator = typename Allocator::template rebind<bucket>::other;
+
+		__device__
+		size_type first_bucket(size_type const h) const
+		{
+			return h & mask;
+		}
+
+		__device__
+		size_type second_bucket(size_type const h) const
+		{
+			size_type const b = (h >> 32) & mask;
+			return b != (h & mask) ? b : ((h & mask) ^ 1) & mask;
+		}
+
+		__device__
+		bool in_bucket(bucket const& bk, key_type const& key) const
+		{
+			bool found = false;
+			for (size_type s = 0; s != BucketSize; ++s)
+				found |= equal(bk.keys[s], key);
+			return found;
+		}
+
+		__device__
+		bool erase_from(bucket& bk, key_type const& key)
+		{
+			for (size_type s = 0; s != BucketSize; ++s)
+			{
+				if (equal(bk.keys[s], key))
+				{
+					bk.keys[s] = empty_key;
+					return true;
+				}
+			}
+			return false;
+		}
+
+		__device__
+		bool place_in(bucket& bk, key_type const& key)
+		{
+			for (size_type s = 0; s != BucketSize; ++s)
+			{
+				if (equal(bk.keys[s], empty_key))
+				{
+					bk.keys[s] = key;
+					return true;
+				}
+			}
+			return false;
+		}
+
+		/**
+		*	Stores @key in one of its buckets, evicting keys along a chain of at most max_evictions steps, or in the stash.
+		*	@key - key to store, on failure it holds the key that was left without a slot.
+		*	Returns false if neither the buckets nor the stash had room.
+		*/
+		__device__
+		bool place(Key& key)
+		{
+			size_type h = hash(key);
+			size_type b = first_bucket(h);
+			if (place_in(buckets[b], key) || place_in(buckets[second_bucket(h)], key))
+				return true;
+
+			for (size_type step = 0; step != max_evictions; ++step)
+			{
+				// Evict a pseudo-randomly chosen slot, so that the chain does not cycle between the same two keys.
+				seed ^= seed << 13;
+				seed ^= seed >> 7;
+				seed ^= seed << 17;
+				Key& victim = buckets[b].keys[seed % BucketSize];
+				Key const evicted = victim;
+				victim = key;
+				key = evicted;
+				h = hash(key);
+				b = (b == first_bucket(h)) ? second_bucket(h) : first_bucket(h);
+				if (place_in(buckets[b], key))
+					return true;
+			}
+
+			if (stash_size != stash_capacity)
+			{
+				stash[stash_size++] = key;
+				return true;
+			}
+			return false;
+		}
+
+		/**
+		*	Doubles the number of buckets until every key, including @pending which had no slot, has been placed.
+		*/
+		__device__
+		void grow(Key const& pending)
+		{
+			bucket* const old_raw = raw;
+			bucket* const old_buckets = buckets;
+			size_type const old_count = mask + 1;
+			Key old_stash[stash_capacity];
+			size_type const old_stash_size = stash_size;
+			for (size_type i = 0; i != old_stash_size; ++i)
+				old_stash[i] = stash[i];
+
+			for (size_type count = 2 * old_count; ; count *= 2)
+			{
+				allocate_space(count);
+				stash_size = 0;
+				if (rebuild(old_buckets, old_count, old_stash, old_stash_size, pending))
+					break;
+				deallocate_buckets(raw, count);
+			}
+			deallocate_buckets(old_raw, old_count);
+		}
+
+		/**
+		*	Places the keys of an old set of buckets, its stash and @pending into the current buckets.
+		*	Returns false if some key could not be placed.
+		*/
+		__device__
+		bool rebuild(bucket const* old_buckets, size_type const old_count, Key const* old_stash, size_type const old_stash_size, Key const& pending)
+		{
+			for (size_type b = 0; b != old_count; ++b)
+			{
+				for (size_type s = 0; s != BucketSize; ++s)
+				{
+					Key k = old_buckets[b].keys[s];
+					if (!equal(k, empty_key) && !place(k)) return false;
+				}
+			}
+			for (size_type i = 0; i != old_stash_size; ++i)
+			{
+				Key k = old_stash[i];
+				if (!place(k)) return false;
+			}
+			Key k = pending;
+			return place(k);
+		}
+
+		/**
+		*	Returns the number of buckets, a power of two, with enough slots for @n keys.
+		*/
+		__device__
+		static size_type bucket_count_for(size_type const n)
+		{
+			size_type const count = static_cast<size_type>(cudlb::bit_ceil((n + BucketSize - 1) / BucketSize));
+			return count < 2 ? 2 : count;
+		}
+
+		/**
+		*	Allocates @count empty buckets, aligned to bucket_alignment.
+		*	NOTE: One extra bucket is allocated, the allocator only guarantees the alignment of fundamental types.
+		*/
+		__device__
+		void allocate_space(size_type const count)
+		{
+			raw = alloc.allocate(count + 1);
+			uintptr_t const address = reinterpret_cast<uintptr_t>(raw);
+			buckets = reinterpret_cast<bucket*>((address + bucket_alignment - 1) & ~static_cast<uintptr_t>(bucket_alignment - 1));
+			mask = count - 1;
+			for (size_type b = 0; b != count; ++b)
+			{
+				for (size_type s = 0; s != BucketSize; ++s)
+					buckets[b].keys[s] = empty_key;
+			}
+		}
+
+		__device__
+		void deallocate_buckets(bucket* p, size_type const count)
+		{
+			alloc.deallocate(p, count + 1);
+		}
+
+		__device__
+		void deallocate_space()
+		{
+			deallocate_buckets(raw, mask + 1);
+			raw = buckets = nullptr;
+		}
+
+		Hash hash;
+		KeyEqual equal;
+		bucket_allocator alloc;
+		bucket* raw;		// Start of the allocation.
+		bucket* buckets;	// First aligned bucket within the allocation.
+		size_type mask;		// Number of buckets minus one.
+		size_type occupied;
+		size_type stash_size;
+		Key stash[stash_capacity];
+		Key empty_key;
+		unsigned long long seed;	// State of the xorshift generator choosing eviction victims.
+	};
+}
\ No newline at end of file
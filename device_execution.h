@@ -0,0 +1,328 @@
+#pragma once
+#include <new>
+#include <cstdlib>
+#include "device_config.h"
+#include "device_type_traits.h"
+#if !defined(__CUDA_ARCH__)
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#endif
+
+namespace cudlb
+{
+	/**
+	*	Execution policies, passed as the first argument of an algorithm to select its implementation.
+	*	seq runs the plain serial loop. par splits the range into tiles which are processed by the host thread pool
+	*	in host builds, in device code the tiles of a par algorithm are processed one after another by the calling thread.
+	*/
+	struct sequenced_policy {};
+	struct parallel_policy {};
+
+	constexpr sequenced_policy seq{};
+	constexpr parallel_policy par{};
+
+	/**
+	*	True for the execution policy types, used to keep the serial overloads of an algorithm from deducing
+	*	their first iterator as a policy when a par overload takes the same number of arguments.
+	*/
+	template<typename T>
+	struct is_execution_policy : cudlb::false_type {};
+
+	template<> struct is_execution_policy<cudlb::sequenced_policy> : cudlb::true_type {};
+	template<> struct is_execution_policy<cudlb::parallel_policy> : cudlb::true_type {};
+
+	/**
+	*	True if every one of the iterator types is random access, which the par algorithms need to split their
+	*	ranges into tiles. For other iterators, such as those of node based containers, they run the serial loop.
+	*/
+	template<typename... Iterators>
+	struct parallel_iterators : cudlb::true_type {};
+
+	template<typename Iterator, typename... Iterators>
+	struct parallel_iterators<Iterator, Iterators...> : cudlb::integral_constant<bool,
+		cudlb::is_iterator_category<Iterator, cudlb::random_access_iterator_tag>::value && cudlb::parallel_iterators<Iterators...>::value> {};
+
+	/**
+	*	Splits n elements into tiles of nearly equal size, tile t covers [begin(t) : end(t)).
+	*/
+	struct tiling {
+		size_t n;
+		size_t tiles;
+
+		__host__ __device__
+		size_t begin(size_t const t) const
+		{
+			return n / tiles * t + (t < n % tiles ? t : n % tiles);
+		}
+
+		__host__ __device__
+		size_t end(size_t const t) const
+		{
+			return begin(t + 1);
+		}
+	};
+
+	/**
+	*	Uninitialized array holding one object per tile, such as the partial results of a parallel algorithm.
+	*	Objects are constructed by the tiles, possibly concurrently, each tile constructing its own entry.
+	*	NOTE: Every entry has to be constructed before the buffer is destroyed.
+	*/
+	template<typename T>
+	class tile_buffer {
+	public:
+		__host__ __device__
+		explicit tile_buffer(size_t const n)
+			: data{ static_cast<T*>(::operator new(n * sizeof(T))) }, n{ n } {}
+
+		__host__ __device__
+		~tile_buffer()
+		{
+			for (size_t i = 0; i != n; ++i)
+				data[i].~T();
+			::operator delete(data);
+		}
+
+		tile_buffer(tile_buffer const&) = delete;
+
+		tile_buffer const& operator=(tile_buffer const&) = delete;
+
+		template<typename... Arg>
+		__host__ __device__
+		void construct(size_t const i, Arg &&... arg)
+		{
+			::new(static_cast<void*>(data + i)) T(static_cast<Arg&&>(arg)...);
+		}
+
+		__host__ __device__
+		T& operator[](size_t const i) const
+		{
+			return data[i];
+		}
+
+	private:
+		T* data;
+		size_t n;
+	};
+
+	/**
+	*	Scratch space for an algorithm which can fall back to a slower method when memory is short.
+	*	The allocation does not fail loudly, data() is null if it could not be made.
+	*	Objects are constructed one after another with push_back() and destroyed with the buffer.
+	*/
+	template<typename T>
+	class temporary_buffer {
+	public:
+		__host__ __device__
+		explicit temporary_buffer(size_t const capacity)
+			: data_{ nullptr }, count{ 0 }
+		{
+		#if defined(__CUDA_ARCH__)
+			data_ = static_cast<T*>(malloc(capacity * sizeof(T)));
+		#else
+			data_ = static_cast<T*>(::operator new(capacity * sizeof(T), std::nothrow));
+		#endif
+		}
+
+		__host__ __device__
+		~temporary_buffer()
+		{
+			for (size_t i = 0; i != count; ++i)
+				data_[i].~T();
+		#if defined(__CUDA_ARCH__)
+			free(data_);
+		#else
+			::operator delete(data_);
+		#endif
+		}
+
+		temporary_buffer(temporary_buffer const&) = delete;
+
+		temporary_buffer const& operator=(temporary_buffer const&) = delete;
+
+		template<typename... Arg>
+		__host__ __device__
+		void push_back(Arg &&... arg)
+		{
+			::new(static_cast<void*>(data_ + count)) T(static_cast<Arg&&>(arg)...);
+			++count;
+		}
+
+		__host__ __device__
+		T* data() const
+		{
+			return data_;
+		}
+
+		__host__ __device__
+		size_t size() const
+		{
+			return count;
+		}
+
+	private:
+		T* data_;
+		size_t count;
+	};
+
+#if !defined(__CUDA_ARCH__)
+	/**
+	*	Fixed set of worker threads running the tiles of parallel algorithms in host builds.
+	*	The calling thread works on the tiles too and run() returns once all of them are done.
+	*	Only one job runs at a time, a job submitted while another one is running, for example from inside a tile,
+	*	is run by the submitting thread alone, so nested parallel algorithms never deadlock.
+	*/
+	class host_thread_pool {
+	public:
+		/**
+		*	Starts the workers.
+		*	@threads - total number of threads working on a job, including the calling thread.
+		*/
+		explicit host_thread_pool(unsigned int threads = std::thread::hardware_concurrency())
+			: job_tasks{ 0 }, next{ 0 }, active{ 0 }, generation{ 0 }, stop{ false }, busy{ false }
+		{
+			for (unsigned int i = 1; i < threads; ++i)
+				workers.emplace_back([this] { work(); });
+		}
+
+		~host_thread_pool()
+		{
+			{
+				std::lock_guard<std::mutex> lock{ m };
+				stop = true;
+			}
+			wake.notify_all();
+			for (std::thread& t : workers)
+				t.join();
+		}
+
+		host_thread_pool(host_thread_pool const&) = delete;
+
+		host_thread_pool const& operator=(host_thread_pool const&) = delete;
+
+		/**
+		*	Returns the number of threads working on a job, including the calling thread.
+		*/
+		unsigned int size() const
+		{
+			return static_cast<unsigned int>(workers.size()) + 1;
+		}
+
+		/**
+		*	Calls @f(i) for every i in [0 : tasks) and waits for all calls to return.
+		*	@tasks - number of tasks.
+		*	@f - function object called once per task, possibly from several threads at the same time.
+		*/
+		template<typename Function>
+		void run(size_t const tasks, Function const& f)
+		{
+			bool idle = false;
+			if (tasks <= 1 || workers.empty() || !busy.compare_exchange_strong(idle, true))
+			{
+				for (size_t i = 0; i != tasks; ++i)
+					f(i);
+				return;
+			}
+			{
+				std::lock_guard<std::mutex> lock{ m };
+				job = [&f](size_t const i) { f(i); };
+				job_tasks = tasks;
+				next.store(0);
+				active = workers.size();
+				++generation;
+			}
+			wake.notify_all();
+			drain();
+			{
+				std::unique_lock<std::mutex> lock{ m };
+				finished.wait(lock, [this] { return active == 0; });
+				job = nullptr;
+			}
+			busy.store(false);
+		}
+
+	private:
+		/**
+		*	Takes tasks of the current job until there are none left.
+		*/
+		void drain()
+		{
+			for (size_t i = next.fetch_add(1); i < job_tasks; i = next.fetch_add(1))
+				job(i);
+		}
+
+		void work()
+		{
+			unsigned long long seen = 0;
+			std::unique_lock<std::mutex> lock{ m };
+			while (true)
+			{
+				wake.wait(lock, [&] { return stop || generation != seen; });
+				if (stop) return;
+				seen = generation;
+				lock.unlock();
+				drain();
+				lock.lock();
+				if (--active == 0) finished.notify_one();
+			}
+		}
+
+		std::vector<std::thread> workers;
+		std::mutex m;
+		std::condition_variable wake;
+		std::condition_variable finished;
+		std::function<void(size_t)> job;
+		size_t job_tasks;
+		std::atomic<size_t> next;		// Next task of the current job to be taken.
+		size_t active;					// Workers which have not finished the current job yet.
+		unsigned long long generation;	// Incremented for every job, wakes the workers.
+		bool stop;
+		std::atomic<bool> busy;			// Set while a job runs.
+	};
+
+	/**
+	*	Returns the thread pool used by the parallel algorithms, started on first use.
+	*/
+	inline host_thread_pool& default_thread_pool()
+	{
+		static host_thread_pool pool;
+		return pool;
+	}
+#endif
+
+	/**
+	*	Splits @n elements into tiles for a parallel algorithm, a few tiles per thread to balance the load,
+	*	but none smaller than @min_tile elements unless there is a single tile.
+	*/
+	__host__ __device__
+	inline cudlb::tiling make_tiling(size_t const n, size_t const min_tile = 16384)
+	{
+	#if defined(__CUDA_ARCH__)
+		size_t const max_tiles = 1;
+	#else
+		size_t const max_tiles = 4 * static_cast<size_t>(cudlb::default_thread_pool().size());
+	#endif
+		size_t tiles = n / min_tile;
+		if (tiles > max_tiles) tiles = max_tiles;
+		if (tiles == 0) tiles = 1;
+		return cudlb::tiling{ n, tiles };
+	}
+
+	/**
+	*	Calls @f(i) for every i in [0 : tasks), on the host thread pool in host builds.
+	*/
+	template<typename Function>
+	__host__ __device__
+	void parallel_for(size_t const tasks, Function const& f)
+	{
+	#if defined(__CUDA_ARCH__)
+		for (size_t i = 0; i != tasks; ++i)
+			f(i);
+	#else
+		cudlb::default_thread_pool().run(tasks, f);
+	#endif
+	}
+}
@@ -0,0 +1,425 @@
+#pragma once
+#include "device_type_traits.h"
+#include "device_utility.h"
+#include "device_vector.h"
+#include "device_array.h"
+
+namespace cudlb
+{
+	/**
+	*	Element-wise expression templates for device_vector and device_array, enabled by including this header.
+	*	Arithmetic, comparison and where() expressions over containers and scalars do not compute anything,
+	*	they return a tree of expression nodes holding their operands. Assigning the tree to a container evaluates
+	*	it in a single loop, element i of every operand combined in one step, so
+	*
+	*		a = b * c + d;
+	*
+	*	reads b, c and d once and writes a once, with no temporary containers, and compiles to a loop the compiler
+	*	can vectorize. Containers are held by pointer, they have to outlive the expression.
+	*	The size of an expression is the size of its shortest container, assigning it to a longer container throws.
+	*	NOTE: Comparing two containers keeps its lexicographic meaning, cudlb::expr(a) < b compares element-wise.
+	*/
+
+	/**
+	*	Size of a node combining two operands, the shorter of them, ignoring scalars which have size 0.
+	*/
+	__host__ __device__
+	inline size_t expression_size(size_t const a, size_t const b)
+	{
+		return a == 0 ? b : (b == 0 || a < b ? a : b);
+	}
+
+	/**
+	*	Leaf of an expression, the elements of a contiguous container.
+	*/
+	template<typename T>
+	struct array_expression : cudlb::expression<array_expression<T>> {
+		T const* data;
+		size_t n;
+
+		__host__ __device__
+		array_expression(T const* data, size_t const n)
+			: data{ data }, n{ n }
+		{}
+
+		__host__ __device__
+		T const& operator[](size_t const i) const
+		{
+			return data[i];
+		}
+
+		__host__ __device__
+		size_t size() const
+		{
+			return n;
+		}
+	};
+
+	/**
+	*	Leaf of an expression, a scalar used with every element. Its size is 0, it fits expressions of any size.
+	*/
+	template<typename T>
+	struct scalar_expression : cudlb::expression<scalar_expression<T>> {
+		T value;
+
+		__host__ __device__
+		explicit scalar_expression(T const value)
+			: value{ value }
+		{}
+
+		__host__ __device__
+		T operator[](size_t const) const
+		{
+			return value;
+		}
+
+		__host__ __device__
+		size_t size() const
+		{
+			return 0;
+		}
+	};
+
+	/**
+	*	Node applying a unary operation to every element of its operand.
+	*/
+	template<typename Op, typename E>
+	struct unary_expression : cudlb::expression<unary_expression<Op, E>> {
+		E operand;
+
+		__host__ __device__
+		explicit unary_expression(E const& operand)
+			: operand{ operand }
+		{}
+
+		__host__ __device__
+		auto operator[](size_t const i) const
+		{
+			return Op()(operand[i]);
+		}
+
+		__host__ __device__
+		size_t size() const
+		{
+			return operand.size();
+		}
+	};
+
+	/**
+	*	Node applying a binary operation to the elements of its operands at the same position.
+	*/
+	template<typename Op, typename L, typename R>
+	struct binary_expression : cudlb::expression<binary_expression<Op, L, R>> {
+		L lhs;
+		R rhs;
+
+		__host__ __device__
+		binary_expression(L const& lhs, R const& rhs)
+			: lhs{ lhs }, rhs{ rhs }
+		{}
+
+		__host__ __device__
+		auto operator[](size_t const i) const
+		{
+			return Op()(lhs[i], rhs[i]);
+		}
+
+		__host__ __device__
+		size_t size() const
+		{
+			return cudlb::expression_size(lhs.size(), rhs.size());
+		}
+	};
+
+	/**
+	*	Node selecting, at every position, the element of @x where the condition holds and the element of @y elsewhere.
+	*/
+	template<typename C, typename X, typename Y>
+	struct where_expression : cudlb::expression<where_expression<C, X, Y>> {
+		C condition;
+		X x;
+		Y y;
+
+		__host__ __device__
+		where_expression(C const& condition, X const& x, Y const& y)
+			: condition{ condition }, x{ x }, y{ y }
+		{}
+
+		__host__ __device__
+		auto operator[](size_t const i) const
+		{
+			// Both sides are evaluated, so the selection needs no branch.
+			auto const a = x[i];
+			auto const b = y[i];
+			return condition[i] ? a : b;
+		}
+
+		__host__ __device__
+		size_t size() const
+		{
+			return cudlb::expression_size(condition.size(), cudlb::expression_size(x.size(), y.size()));
+		}
+	};
+
+	/**
+	*	Converts an operand of an element-wise operator into an expression node, type is the node type.
+	*	Defined for expression nodes, device_vector, device_array and arithmetic scalars, for any other type it has
+	*	no members, which removes the operators from overload resolution.
+	*/
+	template<typename T, bool Scalar = cudlb::is_integral<T>::value || cudlb::is_floating_point<T>::value>
+	struct expression_operand {};
+
+	template<typename T>
+	struct expression_operand<T, true> {
+		using type = cudlb::scalar_expression<T>;
+
+		__host__ __device__
+		static type make(T const value)
+		{
+			return type{ value };
+		}
+	};
+
+	template<typename T, typename Allocator>
+	struct expression_operand<cudlb::device_vector<T, Allocator>, false> {
+		using type = cudlb::array_expression<T>;
+
+		__device__
+		static type make(cudlb::device_vector<T, Allocator> const& v)
+		{
+			return type{ v.begin(), v.size() };
+		}
+	};
+
+	template<typename T, size_t N>
+	struct expression_operand<cudlb::device_array<T, N>, false> {
+		using type = cudlb::array_expression<T>;
+
+		__device__
+		static type make(cudlb::device_array<T, N> const& a)
+		{
+			return type{ a.begin(), N };
+		}
+	};
+
+	/**
+	*	Expression nodes are operands as they are.
+	*/
+	template<typename E>
+	struct expression_node_operand {
+		using type = E;
+
+		__host__ __device__
+		static E const& make(E const& e)
+		{
+			return e;
+		}
+	};
+
+	template<typename T>
+	struct expression_operand<cudlb::array_expression<T>, false> : cudlb::expression_node_operand<cudlb::array_expression<T>> {};
+
+	template<typename T>
+	struct expression_operand<cudlb::scalar_expression<T>, false> : cudlb::expression_node_operand<cudlb::scalar_expression<T>> {};
+
+	template<typename Op, typename E>
+	struct expression_operand<cudlb::unary_expression<Op, E>, false> : cudlb::expression_node_operand<cudlb::unary_expression<Op, E>> {};
+
+	template<typename Op, typename L, typename R>
+	struct expression_operand<cudlb::binary_expression<Op, L, R>, false> : cudlb::expression_node_operand<cudlb::binary_expression<Op, L, R>> {};
+
+	template<typename C, typename X, typename Y>
+	struct expression_operand<cudlb::where_expression<C, X, Y>, false> : cudlb::expression_node_operand<cudlb::where_expression<C, X, Y>> {};
+
+	/**
+	*	Returns the expression leaf of a container, the way to start an element-wise comparison of two containers.
+	*	@c - device_vector or device_array.
+	*/
+	template<typename Container>
+	__device__
+	typename cudlb::expression_operand<Container>::type expr(Container const& c)
+	{
+		return cudlb::expression_operand<Container>::make(c);
+	}
+
+	/**
+	*	Element-wise operations of the expression nodes.
+	*/
+	struct negate_op {
+		template<typename A>
+		__host__ __device__
+		auto operator()(A const& a) const { return -a; }
+	};
+
+	struct plus_op {
+		template<typename A, typename B>
+		__host__ __device__
+		auto operator()(A const& a, B const& b) const { return a + b; }
+	};
+
+	struct minus_op {
+		template<typename A, typename B>
+		__host__ __device__
+		auto operator()(A const& a, B const& b) const { return a - b; }
+	};
+
+	struct multiplies_op {
+		template<typename A, typename B>
+		__host__ __device__
+		auto operator()(A const& a, B const& b) const { return a * b; }
+	};
+
+	struct divides_op {
+		template<typename A, typename B>
+		__host__ __device__
+		auto operator()(A const& a, B const& b) const { return a / b; }
+	};
+
+	struct less_op {
+		template<typename A, typename B>
+		__host__ __device__
+		bool operator()(A const& a, B const& b) const { return a < b; }
+	};
+
+	struct greater_op {
+		template<typename A, typename B>
+		__host__ __device__
+		bool operator()(A const& a, B const& b) const { return b < a; }
+	};
+
+	struct less_equal_op {
+		template<typename A, typename B>
+		__host__ __device__
+		bool operator()(A const& a, B const& b) const { return !(b < a); }
+	};
+
+	struct greater_equal_op {
+		template<typename A, typename B>
+		__host__ __device__
+		bool operator()(A const& a, B const& b) const { return !(a < b); }
+	};
+
+	struct equal_op {
+		template<typename A, typename B>
+		__host__ __device__
+		bool operator()(A const& a, B const& b) const { return a == b; }
+	};
+
+	struct not_equal_op {
+		template<typename A, typename B>
+		__host__ __device__
+		bool operator()(A const& a, B const& b) const { return !(a == b); }
+	};
+
+	/**
+	*	Type of the node combining operands L and R with the operation Op.
+	*/
+	template<typename Op, typename L, typename R>
+	using binary_node = cudlb::binary_expression<Op, typename cudlb::expression_operand<L>::type, typename cudlb::expression_operand<R>::type>;
+
+	/**
+	*	Builds the node combining two operands, at least one of which is a container or an expression.
+	*/
+	template<typename Op, typename L, typename R>
+	__device__
+	cudlb::binary_node<Op, L, R> make_binary_node(L const& lhs, R const& rhs)
+	{
+		return cudlb::binary_node<Op, L, R>{ cudlb::expression_operand<L>::make(lhs), cudlb::expression_operand<R>::make(rhs) };
+	}
+
+	template<typename E>
+	__device__
+	cudlb::unary_expression<cudlb::negate_op, typename cudlb::expression_operand<E>::type> operator-(E const& e)
+	{
+		return cudlb::unary_expression<cudlb::negate_op, typename cudlb::expression_operand<E>::type>{ cudlb::expression_operand<E>::make(e) };
+	}
+
+	template<typename L, typename R>
+	__device__
+	cudlb::binary_node<cudlb::plus_op, L, R> operator+(L const& lhs, R const& rhs)
+	{
+		return cudlb::make_binary_node<cudlb::plus_op>(lhs, rhs);
+	}
+
+	template<typename L, typename R>
+	__device__
+	cudlb::binary_node<cudlb::minus_op, L, R> operator-(L const& lhs, R const& rhs)
+	{
+		return cudlb::make_binary_node<cudlb::minus_op>(lhs, rhs);
+	}
+
+	template<typename L, typename R>
+	__device__
+	cudlb::binary_node<cudlb::multiplies_op, L, R> operator*(L const& lhs, R const& rhs)
+	{
+		return cudlb::make_binary_node<cudlb::multiplies_op>(lhs, rhs);
+	}
+
+	template<typename L, typename R>
+	__device__
+	cudlb::binary_node<cudlb::divides_op, L, R> operator/(L const& lhs, R const& rhs)
+	{
+		return cudlb::make_binary_node<cudlb::divides_op>(lhs, rhs);
+	}
+
+	template<typename L, typename R>
+	__device__
+	cudlb::binary_node<cudlb::less_op, L, R> operator<(L const& lhs, R const& rhs)
+	{
+		return cudlb::make_binary_node<cudlb::less_op>(lhs, rhs);
+	}
+
+	template<typename L, typename R>
+	__device__
+	cudlb::binary_node<cudlb::greater_op, L, R> operator>(L const& lhs, R const& rhs)
+	{
+		return cudlb::make_binary_node<cudlb::greater_op>(lhs, rhs);
+	}
+
+	template<typename L, typename R>
+	__device__
+	cudlb::binary_node<cudlb::less_equal_op, L, R> operator<=(L const& lhs, R const& rhs)
+	{
+		return cudlb::make_binary_node<cudlb::less_equal_op>(lhs, rhs);
+	}
+
+	template<typename L, typename R>
+	__device__
+	cudlb::binary_node<cudlb::greater_equal_op, L, R> operator>=(L const& lhs, R const& rhs)
+	{
+		return cudlb::make_binary_node<cudlb::greater_equal_op>(lhs, rhs);
+	}
+
+	template<typename L, typename R>
+	__device__
+	cudlb::binary_node<cudlb::equal_op, L, R> operator==(L const& lhs, R const& rhs)
+	{
+		return cudlb::make_binary_node<cudlb::equal_op>(lhs, rhs);
+	}
+
+	template<typename L, typename R>
+	__device__
+	cudlb::binary_node<cudlb::not_equal_op, L, R> operator!=(L const& lhs, R const& rhs)
+	{
+		return cudlb::make_binary_node<cudlb::not_equal_op>(lhs, rhs);
+	}
+
+	/**
+	*	Selects element-wise between two operands.
+	*	@condition - expression or container giving the condition at every position.
+	*	@x - operand taken where the condition holds.
+	*	@y - operand taken where it does not.
+	*	NOTE: The condition cannot be a scalar. Comparing two containers, as in where(b < c, b, c), gives a single
+	*	lexicographic bool, which would select for all elements at once; write where(cudlb::expr(b) < c, b, c).
+	*/
+	template<typename C, typename X, typename Y>
+	__device__
+	cudlb::where_expression<typename cudlb::expression_operand<C>::type, typename cudlb::expression_operand<X>::type, typename cudlb::expression_operand<Y>::type>
+		where(C const& condition, X const& x, Y const& y)
+	{
+		static_assert(!cudlb::is_integral<C>::value && !cudlb::is_floating_point<C>::value,
+			"cudlb::where requires an element-wise condition, compare containers with cudlb::expr(a) < b");
+		using node = cudlb::where_expression<typename cudlb::expression_operand<C>::type, typename cudlb::expression_operand<X>::type, typename cudlb::expression_operand<Y>::type>;
+		return node{ cudlb::expression_operand<C>::make(condition), cudlb::expression_operand<X>::make(x), cudlb::expression_operand<Y>::make(y) };
+	}
+}
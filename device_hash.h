@@ -0,0 +1,225 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include "device_utility.h"
+#include "device_type_traits.h"
+#if !defined(__CUDA_ARCH__) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace cudlb
+{
+	/**
+	*	Mixes the bits of a 64-bit value with multiply-xorshift rounds (the MurmurHash3 finalizer),
+	*	so that keys differing in any single bit differ in about half of the result bits.
+	*	@x - value to mix.
+	*/
+	__host__ __device__
+	inline unsigned long long hash_mix(unsigned long long x)
+	{
+		x ^= x >> 33;
+		x *= 0xff51afd7ed558ccdULL;
+		x ^= x >> 33;
+		x *= 0xc4ceb9fe1a85ec53ULL;
+		x ^= x >> 33;
+		return x;
+	}
+
+	/**
+	*	Multiplies two 64-bit values into a 128-bit product.
+	*	@lo - receives the low half of the product.
+	*	@hi - receives the high half of the product.
+	*/
+	__host__ __device__
+	inline void multiply_wide(unsigned long long const a, unsigned long long const b, unsigned long long& lo, unsigned long long& hi)
+	{
+	#if defined(__CUDA_ARCH__)
+		lo = a * b;
+		hi = __umul64hi(a, b);
+	#elif defined(_MSC_VER)
+		lo = _umul128(a, b, &hi);
+	#else
+		unsigned __int128 const r = static_cast<unsigned __int128>(a) * b;
+		lo = static_cast<unsigned long long>(r);
+		hi = static_cast<unsigned long long>(r >> 64);
+	#endif
+	}
+
+	/**
+	*	Multiplies two 64-bit values and folds the 128-bit product into 64 bits.
+	*/
+	__host__ __device__
+	inline unsigned long long multiply_fold(unsigned long long const a, unsigned long long const b)
+	{
+		unsigned long long lo;
+		unsigned long long hi;
+		cudlb::multiply_wide(a, b, lo, hi);
+		return lo ^ hi;
+	}
+
+	/**
+	*	Reads 8 bytes from a possibly unaligned address.
+	*/
+	__host__ __device__
+	inline unsigned long long read_8_bytes(unsigned char const* p)
+	{
+		unsigned long long r;
+		memcpy(&r, p, 8);
+		return r;
+	}
+
+	/**
+	*	Reads 4 bytes from a possibly unaligned address.
+	*/
+	__host__ __device__
+	inline unsigned long long read_4_bytes(unsigned char const* p)
+	{
+		unsigned int r;
+		memcpy(&r, p, 4);
+		return r;
+	}
+
+	/**
+	*	Hashes a range of bytes, following the wyhash algorithm.
+	*	Input is consumed in 8-byte blocks, 48 bytes per iteration for long ranges, each pair of blocks
+	*	folded into the state with a 64x64 to 128-bit multiplication. Ranges of up to 16 bytes take no loop at all.
+	*	@data - start of the range, no alignment is required.
+	*	@len - length of the range in bytes.
+	*	@seed - initial state, different seeds give independent hash functions.
+	*	NOTE: Blocks are read in the byte order of the machine, host and device builds agree on little-endian targets.
+	*/
+	__host__ __device__
+	inline unsigned long long hash_bytes(void const* data, size_t const len, unsigned long long seed = 0)
+	{
+		unsigned long long const s0 = 0xa0761d6478bd642fULL;
+		unsigned long long const s1 = 0xe7037ed1a0b428dbULL;
+		unsigned long long const s2 = 0x8ebc6af09c88c6e3ULL;
+		unsigned long long const s3 = 0x589965cc75374cc3ULL;
+
+		unsigned char const* p = static_cast<unsigned char const*>(data);
+		seed ^= cudlb::multiply_fold(seed ^ s0, s1);
+		unsigned long long a;
+		unsigned long long b;
+		if (len <= 16)
+		{
+			if (len >= 4)
+			{
+				// Two overlapping pairs of 4-byte reads cover any length from 4 to 16.
+				size_t const shift = (len >> 3) << 2;
+				a = (cudlb::read_4_bytes(p) << 32) | cudlb::read_4_bytes(p + shift);
+				b = (cudlb::read_4_bytes(p + len - 4) << 32) | cudlb::read_4_bytes(p + len - 4 - shift);
+			}
+			else if (len > 0)
+			{
+				a = (static_cast<unsigned long long>(p[0]) << 16) | (static_cast<unsigned long long>(p[len >> 1]) << 8) | p[len - 1];
+				b = 0;
+			}
+			else
+			{
+				a = b = 0;
+			}
+		}
+		else
+		{
+			size_t i = len;
+			if (i > 48)
+			{
+				unsigned long long see1 = seed;
+				unsigned long long see2 = seed;
+				do
+				{
+					seed = cudlb::multiply_fold(cudlb::read_8_bytes(p) ^ s1, cudlb::read_8_bytes(p + 8) ^ seed);
+					see1 = cudlb::multiply_fold(cudlb::read_8_bytes(p + 16) ^ s2, cudlb::read_8_bytes(p + 24) ^ see1);
+					see2 = cudlb::multiply_fold(cudlb::read_8_bytes(p + 32) ^ s3, cudlb::read_8_bytes(p + 40) ^ see2);
+					p += 48;
+					i -= 48;
+				} while (i > 48);
+				seed ^= see1 ^ see2;
+			}
+			while (i > 16)
+			{
+				seed = cudlb::multiply_fold(cudlb::read_8_bytes(p) ^ s1, cudlb::read_8_bytes(p + 8) ^ seed);
+				p += 16;
+				i -= 16;
+			}
+			// The last 16 bytes of the range, overlapping blocks already consumed if needed.
+			a = cudlb::read_8_bytes(p + i - 16);
+			b = cudlb::read_8_bytes(p + i - 8);
+		}
+		unsigned long long lo;
+		unsigned long long hi;
+		cudlb::multiply_wide(a ^ s1, b ^ seed, lo, hi);
+		return cudlb::multiply_fold(lo ^ s0 ^ len, hi ^ s1);
+	}
+
+	/**
+	*	Function object for hashing keys of hashed containers.
+	*	All specializations are usable in host and device code and compute identical results in both.
+	*	The primary template takes integral and enumeration keys, which are converted to a 64-bit integer and mixed
+	*	with hash_mix(), so that consecutive keys spread over the whole range of the result.
+	*/
+	template<typename T>
+	struct hash {
+		__host__ __device__
+		size_t operator()(T const& key) const
+		{
+			return static_cast<size_t>(cudlb::hash_mix(static_cast<unsigned long long>(key)));
+		}
+	};
+
+	/**
+	*	Hashes floating point keys by their bit pattern.
+	*	-0.0 hashes like 0.0 and all NaNs hash alike, as required for keys which compare equal.
+	*/
+	template<>
+	struct hash<float> {
+		__host__ __device__
+		size_t operator()(float const key) const
+		{
+			if (key == 0.0f) return static_cast<size_t>(cudlb::hash_mix(0));
+			if (key != key) return static_cast<size_t>(cudlb::hash_mix(0x7fc00000u));
+			return static_cast<size_t>(cudlb::hash_mix(cudlb::bit_cast<unsigned int>(key)));
+		}
+	};
+
+	/**
+	*	Hashes floating point keys by their bit pattern.
+	*	-0.0 hashes like 0.0 and all NaNs hash alike, as required for keys which compare equal.
+	*/
+	template<>
+	struct hash<double> {
+		__host__ __device__
+		size_t operator()(double const key) const
+		{
+			if (key == 0.0) return static_cast<size_t>(cudlb::hash_mix(0));
+			if (key != key) return static_cast<size_t>(cudlb::hash_mix(0x7ff8000000000000ULL));
+			return static_cast<size_t>(cudlb::hash_mix(cudlb::bit_cast<unsigned long long>(key)));
+		}
+	};
+
+	/**
+	*	Hashes pointer keys by their address.
+	*/
+	template<typename T>
+	struct hash<T*> {
+		__host__ __device__
+		size_t operator()(T* const key) const
+		{
+			return static_cast<size_t>(cudlb::hash_mix(static_cast<unsigned long long>(reinterpret_cast<uintptr_t>(key))));
+		}
+	};
+
+	/**
+	*	Function object hashing the object representation of a key with hash_bytes().
+	*	Intended for trivially copyable aggregate keys, which must not contain padding bytes
+	*	as those could differ between keys which compare equal.
+	*/
+	template<typename T>
+	struct bytes_hash {
+		__host__ __device__
+		size_t operator()(T const& key) const
+		{
+			return static_cast<size_t>(cudlb::hash_bytes(&key, sizeof(T)));
+		}
+	};
+}
@@ -0,0 +1,389 @@
+#pragma once
+#include "device_allocator.h"
+#include "device_utility.h"
+#include "device_type_traits.h"
+#include "device_hash.h"
+#include "device_bit.h"
+
+namespace cudlb
+{
+	/**
+	*	Value type of a hash_table which only stores keys, as used by device_unordered_set.
+	*/
+	struct hash_table_no_value {};
+
+	/**
+	*	Value array of a hash_table.
+	*	Values are stored apart from the keys so that probing a slot never pulls value data into the cache.
+	*/
+	template<typename Value, typename Allocator>
+	struct hash_table_values {
+		using allocator = typename Allocator::template rebind<Value>::other;
+		using size_type = size_t;
+
+		template<typename OtherAllocator>
+		__device__
+		explicit hash_table_values(OtherAllocator const& other)
+			: alloc{ other }, data{ nullptr } {}
+
+		__device__
+		void allocate(size_type const n)
+		{
+			data = alloc.allocate(n);
+		}
+
+		__device__
+		void deallocate(size_type const n)
+		{
+			alloc.deallocate(data, n);
+			data = nullptr;
+		}
+
+		/**
+		*	Takes over the array of @other, which is left empty.
+		*/
+		__device__
+		void adopt(hash_table_values& other)
+		{
+			data = other.data;
+			other.data = nullptr;
+		}
+
+		template<typename... Arg>
+		__device__
+		void construct(size_type const i, Arg &&... arg)
+		{
+			alloc.construct(data + i, cudlb::forward<Arg>(arg)...);
+		}
+
+		__device__
+		void destroy(size_type const i)
+		{
+			alloc.destroy(data + i);
+		}
+
+		/**
+		*	Moves the value in slot @from to slot @to of @other, which must be unoccupied.
+		*/
+		__device__
+		void relocate(size_type const from, hash_table_values& other, size_type const to)
+		{
+			other.construct(to, cudlb::move(data[from]));
+			destroy(from);
+		}
+
+		__device__
+		Value& operator[](size_type const i) const
+		{
+			return data[i];
+		}
+
+		allocator alloc;
+		Value* data;
+	};
+
+	/**
+	*	Value array of a key only hash_table, it allocates nothing and all operations are no-ops.
+	*/
+	template<typename Allocator>
+	struct hash_table_values<hash_table_no_value, Allocator> {
+		using size_type = size_t;
+
+		template<typename OtherAllocator>
+		__device__
+		explicit hash_table_values(OtherAllocator const&) {}
+
+		__device__
+		void allocate(size_type const) {}
+
+		__device__
+		void deallocate(size_type const) {}
+
+		__device__
+		void adopt(hash_table_values&) {}
+
+		template<typename... Arg>
+		__device__
+		void construct(size_type const, Arg &&...) {}
+
+		__device__
+		void destroy(size_type const) {}
+
+		__device__
+		void relocate(size_type const, hash_table_values&, size_type const) {}
+	};
+
+	/**
+	*	Open addressing hash table with linear probing, shared by device_unordered_map and device_unordered_set.
+	*	Storage is split into three arrays allocated through the allocator:
+	*	@ctrl - one control byte per slot, 0 for an empty slot, otherwise the top 7 bits of the key's hash with the high bit set.
+	*	@keys - the keys, only read when the control byte of a slot matches.
+	*	@values - the values, only read once a key has been found.
+	*	Erasing shifts the following keys of the probe run back, so the table never holds tombstones
+	*	and lookups of missing keys stop at the first empty slot.
+	*/
+	template<typename Key, typename Value, typename Hash, typename KeyEqual, typename Allocator>
+	class hash_table {
+	public:
+		using key_type = Key;
+		using size_type = size_t;
+		using key_allocator = typename Allocator::template rebind<Key>::other;
+		using ctrl_allocator = typename Allocator::template rebind<unsigned char>::other;
+
+		/**
+		*	Constructs an empty table, no space is allocated until the first insertion or reserve().
+		*/
+		__device__
+		hash_table(Hash const& h, KeyEqual const& e, Allocator const& a)
+			: hash{ h }, equal{ e }, kalloc{ a }, calloc{ a }, values{ a },
+			keys{ nullptr }, ctrl{ nullptr }, slots{ 0 }, occupied{ 0 }, threshold{ 0 }, max_load{ 0.75f }
+		{
+		}
+
+		__device__
+		~hash_table()
+		{
+			clear();
+			deallocate_space();
+		}
+
+		hash_table(hash_table const&) = delete;
+
+		hash_table const& operator=(hash_table const&) = delete;
+
+		/**
+		*	Returned by find_slot() when a key is not in the table.
+		*/
+		static constexpr size_type npos = ~size_type(0);
+
+		/**
+		*	Looks for a key equal to @key.
+		*	@key - key to look for.
+		*	Returns the slot of the key if found, otherwise npos.
+		*/
+		__device__
+		size_type find_slot(key_type const& key) const
+		{
+			if (occupied == 0) return npos;
+			size_type const h = hash(key);
+			unsigned char const tag = tag_of(h);
+			for (size_type i = h & (slots - 1); ; i = (i + 1) & (slots - 1))
+			{
+				if (ctrl[i] == 0) return npos;
+				if (ctrl[i] == tag && equal(keys[i], key)) return i;
+			}
+		}
+
+		/**
+		*	Inserts @key if it is not in the table yet, constructing its value from @arg.
+		*	@key - key to insert.
+		*	@arg - arguments forwarded to the value constructor, ignored if the key is already present.
+		*	Returns the slot of the key and true if the key was inserted, false if it was already present.
+		*	NOTE: Only inserting an absent key can rehash, keys already present are found without growing the table.
+		*/
+		template<typename... Arg>
+		__device__
+		cudlb::pair<size_type, bool> insert_slot(key_type const& key, Arg &&... arg)
+		{
+			size_type const h = hash(key);
+			unsigned char const tag = tag_of(h);
+			size_type i = h & (slots - 1);
+			if (slots != 0)
+			{
+				for (; ctrl[i] != 0; i = (i + 1) & (slots - 1))
+				{
+					if (ctrl[i] == tag && equal(keys[i], key))
+						return cudlb::pair<size_type, bool>{ i, false };
+				}
+			}
+			// The key is absent, only now may the table grow, then the free slot is looked up again.
+			if (occupied + 1 > threshold)
+			{
+				rehash(slots == 0 ? min_slots : 2 * slots);
+				i = h & (slots - 1);
+				while (ctrl[i] != 0)
+					i = (i + 1) & (slots - 1);
+			}
+			ctrl[i] = tag;
+			kalloc.construct(keys + i, key);
+			values.construct(i, cudlb::forward<Arg>(arg)...);
+			++occupied;
+			return cudlb::pair<size_type, bool>{ i, true };
+		}
+
+		/**
+		*	Removes the key in slot @i and shifts the rest of its probe run back to close the gap.
+		*	@i - occupied slot.
+		*/
+		__device__
+		void erase_slot(size_type i)
+		{
+			kalloc.destroy(keys + i);
+			values.destroy(i);
+			--occupied;
+
+			size_type const mask = slots - 1;
+			for (size_type j = (i + 1) & mask; ctrl[j] != 0; j = (j + 1) & mask)
+			{
+				// The key at j may fill the hole at i only if its home slot does not lie cyclically in (i : j].
+				size_type const home = hash(keys[j]) & mask;
+				if (((j - home) & mask) >= ((j - i) & mask))
+				{
+					ctrl[i] = ctrl[j];
+					kalloc.construct(keys + i, cudlb::move(keys[j]));
+					kalloc.destroy(keys + j);
+					values.relocate(j, values, i);
+					i = j;
+				}
+			}
+			ctrl[i] = 0;
+		}
+
+		/**
+		*	Makes room for at least @n keys without exceeding the maximum load factor,
+		*	so that inserting up to @n keys never rehashes.
+		*	@n - number of keys to make room for.
+		*/
+		__device__
+		void reserve(size_type const n)
+		{
+			size_type const needed = static_cast<size_type>(static_cast<double>(n) / max_load);
+			size_type target = static_cast<size_type>(cudlb::bit_ceil(needed < min_slots ? min_slots : needed));
+			while (threshold_of(target) < n) target *= 2;
+			if (slots < target)
+			{
+				rehash(target);
+			}
+		}
+
+		/**
+		*	Destroys all keys and values, the allocated space is kept.
+		*/
+		__device__
+		void clear()
+		{
+			for (size_type i = 0; i != slots; ++i)
+			{
+				if (ctrl[i] != 0)
+				{
+					kalloc.destroy(keys + i);
+					values.destroy(i);
+					ctrl[i] = 0;
+				}
+			}
+			occupied = 0;
+		}
+
+		/**
+		*	Sets the load factor above which the table grows.
+		*	@ml - new maximum load factor, clamped to the range [0.05 : 0.95].
+		*	NOTE: Takes effect on the next insertion, call reserve() to resize right away.
+		*/
+		__device__
+		void set_max_load_factor(float ml)
+		{
+			if (!(ml > 0.05f)) ml = 0.05f;
+			if (ml > 0.95f) ml = 0.95f;
+			max_load = ml;
+			threshold = threshold_of(slots);
+		}
+
+		/**
+		*	Returns the first occupied slot at or after @i, or slots if there is none.
+		*/
+		__device__
+		size_type next_occupied(size_type i) const
+		{
+			while (i < slots && ctrl[i] == 0) ++i;
+			return i;
+		}
+
+		Hash hash;
+		KeyEqual equal;
+		key_allocator kalloc;
+		ctrl_allocator calloc;
+		hash_table_values<Value, Allocator> values;
+		Key* keys;
+		unsigned char* ctrl;
+		size_type slots;	// Number of slots, zero or a power of two.
+		size_type occupied;	// Number of occupied slots.
+		size_type threshold;	// Largest number of keys allowed by the maximum load factor at the current number of slots.
+		float max_load;
+
+	private:
+		/**
+		*	Smallest number of slots allocated by a non-empty table.
+		*/
+		static constexpr size_type min_slots = 16;
+
+		/**
+		*	Returns the control byte of a key, slots are chosen with the low bits of the hash and tags use the top bits.
+		*/
+		__device__
+		static unsigned char tag_of(size_type const h)
+		{
+			return static_cast<unsigned char>(0x80 | (h >> (8 * sizeof(size_type) - 7)));
+		}
+
+		/**
+		*	Returns the largest number of keys @n slots may hold, always leaving at least one slot empty.
+		*/
+		__device__
+		size_type threshold_of(size_type const n) const
+		{
+			size_type const t = static_cast<size_type>(static_cast<double>(n) * max_load);
+			return (n != 0 && t >= n) ? n - 1 : t;
+		}
+
+		/**
+		*	Moves all keys and values into a new set of arrays with @n slots.
+		*	@n - new number of slots, a power of two.
+		*/
+		__device__
+		void rehash(size_type const n)
+		{
+			Key* new_keys = kalloc.allocate(n);
+			unsigned char* new_ctrl = calloc.allocate(n);
+			hash_table_values<Value, Allocator> new_values{ kalloc };
+			new_values.allocate(n);
+			for (size_type i = 0; i != n; ++i)
+			{
+				new_ctrl[i] = 0;
+			}
+
+			for (size_type i = 0; i != slots; ++i)
+			{
+				if (ctrl[i] == 0) continue;
+				size_type j = hash(keys[i]) & (n - 1);
+				while (new_ctrl[j] != 0) j = (j + 1) & (n - 1);
+				new_ctrl[j] = ctrl[i];
+				kalloc.construct(new_keys + j, cudlb::move(keys[i]));
+				kalloc.destroy(keys + i);
+				values.relocate(i, new_values, j);
+			}
+
+			deallocate_space();
+			keys = new_keys;
+			ctrl = new_ctrl;
+			values.adopt(new_values);
+			slots = n;
+			threshold = threshold_of(n);
+		}
+
+		/**
+		*	Returns the arrays to the allocator.
+		*	NOTE: This function does NOT destroy keys and values.
+		*/
+		__device__
+		void deallocate_space()
+		{
+			kalloc.deallocate(keys, slots);
+			calloc.deallocate(ctrl, slots);
+			values.deallocate(slots);
+			keys = nullptr;
+			ctrl = nullptr;
+			slots = 0;
+			threshold = 0;
+		}
+	};
+}
\ No newline at end of file
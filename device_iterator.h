@@ -0,0 +1,853 @@
+#pragma once
+#include <cstddef>
+#include <new>
+#include "device_type_traits.h"
+#include "device_utility.h"
+
+namespace cudlb
+{
+	/**
+	*	Category of an iterator adaptor, the category of the adapted iterator or Limit, whichever is weaker.
+	*	Limit is the strongest category the adaptor supports, for example an adaptor computing its elements
+	*	is never contiguous.
+	*/
+	template<typename Iterator, typename Limit>
+	struct adaptor_iterator_category {
+		using type = typename cudlb::conditional<cudlb::is_iterator_category<Iterator, Limit>::value,
+			Limit, typename cudlb::iterator_traits<Iterator>::iterator_category>::type;
+	};
+
+	/**
+	*	Iterator adaptor which walks a bidirectional sequence backwards.
+	*	Dereferencing a reverse_iterator yields the element just before the adapted iterator,
+	*	so reverse_iterator(end()) refers to the last element and reverse_iterator(begin()) is one past the first.
+	*/
+	template<typename Iterator>
+	struct reverse_iterator {
+		using iterator_type = Iterator;
+		using iterator_category = typename cudlb::adaptor_iterator_category<Iterator, cudlb::bidirectional_iterator_tag>::type;
+		using value_type = typename cudlb::iterator_traits<Iterator>::value_type;
+		using reference = typename cudlb::iterator_traits<Iterator>::reference;
+		using pointer = typename cudlb::iterator_traits<Iterator>::pointer;
+		using difference_type = typename cudlb::iterator_traits<Iterator>::difference_type;
+
+		__host__ __device__
+		explicit reverse_iterator(Iterator it)
+			: current{ it }
+		{}
+
+		/**
+		*	Returns the adapted iterator, which points one element after the one this iterator refers to.
+		*/
+		__host__ __device__
+		Iterator base() const
+		{
+			return current;
+		}
+
+		__host__ __device__
+		reference operator*() const
+		{
+			Iterator temp = current;
+			return *--temp;
+		}
+
+		__host__ __device__
+		reverse_iterator& operator++()
+		{
+			--current;
+			return *this;
+		}
+
+		__host__ __device__
+		reverse_iterator operator++(int)
+		{
+			reverse_iterator temp = *this;
+			--current;
+			return temp;
+		}
+
+		__host__ __device__
+		reverse_iterator& operator--()
+		{
+			++current;
+			return *this;
+		}
+
+		__host__ __device__
+		reverse_iterator operator--(int)
+		{
+			reverse_iterator temp = *this;
+			++current;
+			return temp;
+		}
+
+		__host__ __device__
+		bool operator==(reverse_iterator const& other) const
+		{
+			return current == other.current;
+		}
+
+		__host__ __device__
+		bool operator!=(reverse_iterator const& other) const
+		{
+			return current != other.current;
+		}
+
+		Iterator current;
+	};
+
+	/**
+	*	Random access iterator over consecutive values of an arithmetic type, computed instead of stored.
+	*/
+	template<typename T>
+	struct counting_iterator {
+		using iterator_category = cudlb::random_access_iterator_tag;
+		using value_type = T;
+		using reference = T;
+		using pointer = void;
+		using difference_type = ptrdiff_t;
+		using size_type = size_t;
+
+		__host__ __device__
+		explicit counting_iterator(T value)
+			: current{ value }
+		{}
+
+		__host__ __device__
+		reference operator*() const
+		{
+			return current;
+		}
+
+		__host__ __device__
+		reference operator[](difference_type const n) const
+		{
+			return static_cast<T>(current + n);
+		}
+
+		__host__ __device__
+		counting_iterator& operator++()
+		{
+			++current;
+			return *this;
+		}
+
+		__host__ __device__
+		counting_iterator operator++(int)
+		{
+			counting_iterator temp = *this;
+			++current;
+			return temp;
+		}
+
+		__host__ __device__
+		counting_iterator& operator--()
+		{
+			--current;
+			return *this;
+		}
+
+		__host__ __device__
+		counting_iterator operator--(int)
+		{
+			counting_iterator temp = *this;
+			--current;
+			return temp;
+		}
+
+		__host__ __device__
+		counting_iterator& operator+=(difference_type const n)
+		{
+			current = static_cast<T>(current + n);
+			return *this;
+		}
+
+		__host__ __device__
+		counting_iterator& operator-=(difference_type const n)
+		{
+			current = static_cast<T>(current - n);
+			return *this;
+		}
+
+		__host__ __device__
+		counting_iterator operator+(difference_type const n) const
+		{
+			return counting_iterator{ static_cast<T>(current + n) };
+		}
+
+		__host__ __device__
+		counting_iterator operator-(difference_type const n) const
+		{
+			return counting_iterator{ static_cast<T>(current - n) };
+		}
+
+		__host__ __device__
+		difference_type operator-(counting_iterator const& other) const
+		{
+			return static_cast<difference_type>(current) - static_cast<difference_type>(other.current);
+		}
+
+		__host__ __device__
+		bool operator==(counting_iterator const& other) const
+		{
+			return current == other.current;
+		}
+
+		__host__ __device__
+		bool operator!=(counting_iterator const& other) const
+		{
+			return current != other.current;
+		}
+
+		__host__ __device__
+		bool operator<(counting_iterator const& other) const
+		{
+			return current < other.current;
+		}
+
+		__host__ __device__
+		bool operator>(counting_iterator const& other) const
+		{
+			return other.current < current;
+		}
+
+		__host__ __device__
+		bool operator<=(counting_iterator const& other) const
+		{
+			return !(other.current < current);
+		}
+
+		__host__ __device__
+		bool operator>=(counting_iterator const& other) const
+		{
+			return !(current < other.current);
+		}
+
+		T current;
+	};
+
+	/**
+	*	Holds a function object of an iterator adaptor so that the adaptor can be assigned.
+	*	Lambdas have no copy assignment, assigning the box destroys the function it holds and copy constructs
+	*	the new one in its place, which lets algorithms advance adaptors over lambdas by assignment.
+	*/
+	template<typename F>
+	class assignable_function {
+	public:
+		__host__ __device__
+		explicit assignable_function(F const& f)
+		{
+			::new(static_cast<void*>(storage)) F(f);
+		}
+
+		__host__ __device__
+		assignable_function(assignable_function const& other)
+		{
+			::new(static_cast<void*>(storage)) F(other.get());
+		}
+
+		__host__ __device__
+		assignable_function& operator=(assignable_function const& other)
+		{
+			if (this != &other)
+			{
+				get().~F();
+				::new(static_cast<void*>(storage)) F(other.get());
+			}
+			return *this;
+		}
+
+		__host__ __device__
+		~assignable_function()
+		{
+			get().~F();
+		}
+
+		template<typename... Args>
+		__host__ __device__
+		auto operator()(Args&&... args) const -> decltype(cudlb::declval<F const&>()(static_cast<Args&&>(args)...))
+		{
+			return get()(static_cast<Args&&>(args)...);
+		}
+
+		__host__ __device__
+		F const& get() const
+		{
+			return *reinterpret_cast<F const*>(storage);
+		}
+
+	private:
+		__host__ __device__
+		F& get()
+		{
+			return *reinterpret_cast<F*>(storage);
+		}
+
+		alignas(F) unsigned char storage[sizeof(F)];
+	};
+
+	/**
+	*	Iterator adaptor which applies a function to the elements of a sequence as they are read.
+	*	Nothing is stored, the function runs on every dereference, so it should be cheap and free of side effects.
+	*	Random access if the adapted iterator is.
+	*/
+	template<typename Iterator, typename Function>
+	struct transform_iterator {
+		using iterator_category = typename cudlb::adaptor_iterator_category<Iterator, cudlb::random_access_iterator_tag>::type;
+		using reference = decltype(cudlb::declval<Function const&>()(*cudlb::declval<Iterator const&>()));
+		using value_type = typename cudlb::remove_cv<typename cudlb::remove_reference<reference>::value_type>::value_type;
+		using pointer = void;
+		using difference_type = ptrdiff_t;
+		using size_type = size_t;
+
+		__host__ __device__
+		transform_iterator(Iterator it, Function f)
+			: current{ it }, function{ f }
+		{}
+
+		__host__ __device__
+		reference operator*() const
+		{
+			return function(*current);
+		}
+
+		__host__ __device__
+		reference operator[](difference_type const n) const
+		{
+			return function(current[n]);
+		}
+
+		__host__ __device__
+		transform_iterator& operator++()
+		{
+			++current;
+			return *this;
+		}
+
+		__host__ __device__
+		transform_iterator operator++(int)
+		{
+			transform_iterator temp = *this;
+			++current;
+			return temp;
+		}
+
+		__host__ __device__
+		transform_iterator& operator--()
+		{
+			--current;
+			return *this;
+		}
+
+		__host__ __device__
+		transform_iterator operator--(int)
+		{
+			transform_iterator temp = *this;
+			--current;
+			return temp;
+		}
+
+		__host__ __device__
+		transform_iterator& operator+=(difference_type const n)
+		{
+			current += n;
+			return *this;
+		}
+
+		__host__ __device__
+		transform_iterator& operator-=(difference_type const n)
+		{
+			current -= n;
+			return *this;
+		}
+
+		__host__ __device__
+		transform_iterator operator+(difference_type const n) const
+		{
+			return transform_iterator{ current + n, function.get() };
+		}
+
+		__host__ __device__
+		transform_iterator operator-(difference_type const n) const
+		{
+			return transform_iterator{ current - n, function.get() };
+		}
+
+		__host__ __device__
+		difference_type operator-(transform_iterator const& other) const
+		{
+			return static_cast<difference_type>(current - other.current);
+		}
+
+		__host__ __device__
+		bool operator==(transform_iterator const& other) const
+		{
+			return current == other.current;
+		}
+
+		__host__ __device__
+		bool operator!=(transform_iterator const& other) const
+		{
+			return current != other.current;
+		}
+
+		__host__ __device__
+		bool operator<(transform_iterator const& other) const
+		{
+			return current < other.current;
+		}
+
+		__host__ __device__
+		bool operator>(transform_iterator const& other) const
+		{
+			return other.current < current;
+		}
+
+		__host__ __device__
+		bool operator<=(transform_iterator const& other) const
+		{
+			return !(other.current < current);
+		}
+
+		__host__ __device__
+		bool operator>=(transform_iterator const& other) const
+		{
+			return !(current < other.current);
+		}
+
+		Iterator current;
+		cudlb::assignable_function<Function> function;
+	};
+
+	/**
+	*	Iterator adaptor which skips the elements of a sequence not satisfying a predicate.
+	*	A forward iterator, it has to know the end of the sequence to stop skipping there.
+	*/
+	template<typename Iterator, typename Predicate>
+	struct filter_iterator {
+		using iterator_category = cudlb::forward_iterator_tag;
+		using reference = decltype(*cudlb::declval<Iterator const&>());
+		using value_type = typename cudlb::remove_cv<typename cudlb::remove_reference<reference>::value_type>::value_type;
+		using pointer = void;
+		using difference_type = ptrdiff_t;
+		using size_type = size_t;
+
+		/**
+		*	Constructs an iterator to the first element of [it : last) satisfying the predicate.
+		*/
+		__host__ __device__
+		filter_iterator(Iterator it, Iterator last, Predicate pred)
+			: current{ it }, last{ last }, predicate{ pred }
+		{
+			skip();
+		}
+
+		__host__ __device__
+		reference operator*() const
+		{
+			return *current;
+		}
+
+		__host__ __device__
+		filter_iterator& operator++()
+		{
+			++current;
+			skip();
+			return *this;
+		}
+
+		__host__ __device__
+		filter_iterator operator++(int)
+		{
+			filter_iterator temp = *this;
+			++*this;
+			return temp;
+		}
+
+		__host__ __device__
+		bool operator==(filter_iterator const& other) const
+		{
+			return current == other.current;
+		}
+
+		__host__ __device__
+		bool operator!=(filter_iterator const& other) const
+		{
+			return current != other.current;
+		}
+
+		Iterator current;
+		Iterator last;
+		cudlb::assignable_function<Predicate> predicate;
+
+	private:
+		__host__ __device__
+		void skip()
+		{
+			while (current != last && !predicate(*current))
+				++current;
+		}
+	};
+
+	/**
+	*	Iterator adaptor walking two sequences in step, dereferencing to a pair of their references.
+	*	Elements are modified through the members of the pair, the pair itself cannot be assigned.
+	*	Random access if both adapted iterators are, the difference is taken from the first one.
+	*/
+	template<typename IteratorA, typename IteratorB>
+	struct zip_iterator {
+		using iterator_category = typename cudlb::adaptor_iterator_category<IteratorB,
+			typename cudlb::adaptor_iterator_category<IteratorA, cudlb::random_access_iterator_tag>::type>::type;
+		using reference = cudlb::pair<decltype(*cudlb::declval<IteratorA const&>()), decltype(*cudlb::declval<IteratorB const&>())>;
+		using value_type = cudlb::pair<
+			typename cudlb::remove_cv<typename cudlb::remove_reference<decltype(*cudlb::declval<IteratorA const&>())>::value_type>::value_type,
+			typename cudlb::remove_cv<typename cudlb::remove_reference<decltype(*cudlb::declval<IteratorB const&>())>::value_type>::value_type>;
+		using pointer = void;
+		using difference_type = ptrdiff_t;
+		using size_type = size_t;
+
+		__host__ __device__
+		zip_iterator(IteratorA a, IteratorB b)
+			: first{ a }, second{ b }
+		{}
+
+		__host__ __device__
+		reference operator*() const
+		{
+			return reference{ *first, *second };
+		}
+
+		__host__ __device__
+		reference operator[](difference_type const n) const
+		{
+			return reference{ first[n], second[n] };
+		}
+
+		__host__ __device__
+		zip_iterator& operator++()
+		{
+			++first;
+			++second;
+			return *this;
+		}
+
+		__host__ __device__
+		zip_iterator operator++(int)
+		{
+			zip_iterator temp = *this;
+			++*this;
+			return temp;
+		}
+
+		__host__ __device__
+		zip_iterator& operator--()
+		{
+			--first;
+			--second;
+			return *this;
+		}
+
+		__host__ __device__
+		zip_iterator operator--(int)
+		{
+			zip_iterator temp = *this;
+			--*this;
+			return temp;
+		}
+
+		__host__ __device__
+		zip_iterator& operator+=(difference_type const n)
+		{
+			first += n;
+			second += n;
+			return *this;
+		}
+
+		__host__ __device__
+		zip_iterator& operator-=(difference_type const n)
+		{
+			first -= n;
+			second -= n;
+			return *this;
+		}
+
+		__host__ __device__
+		zip_iterator operator+(difference_type const n) const
+		{
+			return zip_iterator{ first + n, second + n };
+		}
+
+		__host__ __device__
+		zip_iterator operator-(difference_type const n) const
+		{
+			return zip_iterator{ first - n, second - n };
+		}
+
+		__host__ __device__
+		difference_type operator-(zip_iterator const& other) const
+		{
+			return static_cast<difference_type>(first - other.first);
+		}
+
+		__host__ __device__
+		bool operator==(zip_iterator const& other) const
+		{
+			return first == other.first;
+		}
+
+		__host__ __device__
+		bool operator!=(zip_iterator const& other) const
+		{
+			return first != other.first;
+		}
+
+		__host__ __device__
+		bool operator<(zip_iterator const& other) const
+		{
+			return first < other.first;
+		}
+
+		__host__ __device__
+		bool operator>(zip_iterator const& other) const
+		{
+			return other.first < first;
+		}
+
+		__host__ __device__
+		bool operator<=(zip_iterator const& other) const
+		{
+			return !(other.first < first);
+		}
+
+		__host__ __device__
+		bool operator>=(zip_iterator const& other) const
+		{
+			return !(first < other.first);
+		}
+
+		IteratorA first;
+		IteratorB second;
+	};
+
+	/**
+	*	Iterator adaptor visiting every stride-th element of a random access sequence, such as a column of a
+	*	row-major matrix. It holds the start of the sequence and an element index, so the end iterator of a
+	*	strided range never points past the end of the adapted sequence.
+	*/
+	template<typename Iterator>
+	struct strided_iterator {
+		using iterator_category = cudlb::random_access_iterator_tag;
+		using reference = decltype(*cudlb::declval<Iterator const&>());
+		using value_type = typename cudlb::remove_cv<typename cudlb::remove_reference<reference>::value_type>::value_type;
+		using pointer = void;
+		using difference_type = ptrdiff_t;
+		using size_type = size_t;
+
+		__host__ __device__
+		strided_iterator(Iterator base, difference_type const stride, difference_type const index)
+			: base{ base }, stride{ stride }, index{ index }
+		{}
+
+		__host__ __device__
+		reference operator*() const
+		{
+			return base[index * stride];
+		}
+
+		__host__ __device__
+		reference operator[](difference_type const n) const
+		{
+			return base[(index + n) * stride];
+		}
+
+		__host__ __device__
+		strided_iterator& operator++()
+		{
+			++index;
+			return *this;
+		}
+
+		__host__ __device__
+		strided_iterator operator++(int)
+		{
+			strided_iterator temp = *this;
+			++index;
+			return temp;
+		}
+
+		__host__ __device__
+		strided_iterator& operator--()
+		{
+			--index;
+			return *this;
+		}
+
+		__host__ __device__
+		strided_iterator operator--(int)
+		{
+			strided_iterator temp = *this;
+			--index;
+			return temp;
+		}
+
+		__host__ __device__
+		strided_iterator& operator+=(difference_type const n)
+		{
+			index += n;
+			return *this;
+		}
+
+		__host__ __device__
+		strided_iterator& operator-=(difference_type const n)
+		{
+			index -= n;
+			return *this;
+		}
+
+		__host__ __device__
+		strided_iterator operator+(difference_type const n) const
+		{
+			return strided_iterator{ base, stride, index + n };
+		}
+
+		__host__ __device__
+		strided_iterator operator-(difference_type const n) const
+		{
+			return strided_iterator{ base, stride, index - n };
+		}
+
+		__host__ __device__
+		difference_type operator-(strided_iterator const& other) const
+		{
+			return index - other.index;
+		}
+
+		__host__ __device__
+		bool operator==(strided_iterator const& other) const
+		{
+			return index == other.index;
+		}
+
+		__host__ __device__
+		bool operator!=(strided_iterator const& other) const
+		{
+			return index != other.index;
+		}
+
+		__host__ __device__
+		bool operator<(strided_iterator const& other) const
+		{
+			return index < other.index;
+		}
+
+		__host__ __device__
+		bool operator>(strided_iterator const& other) const
+		{
+			return other.index < index;
+		}
+
+		__host__ __device__
+		bool operator<=(strided_iterator const& other) const
+		{
+			return index <= other.index;
+		}
+
+		__host__ __device__
+		bool operator>=(strided_iterator const& other) const
+		{
+			return index >= other.index;
+		}
+
+		Iterator base;
+		difference_type stride;
+		difference_type index;
+	};
+
+	/**
+	*	Moves an iterator by n elements, backwards if n is negative, which requires a bidirectional iterator.
+	*	Takes constant time for random access iterators and n steps for the others.
+	*/
+	template<typename Iterator>
+	__host__ __device__
+	void advance_iterator(Iterator& it, ptrdiff_t n, cudlb::input_iterator_tag)
+	{
+		for (; n > 0; --n)
+			++it;
+	}
+
+	template<typename Iterator>
+	__host__ __device__
+	void advance_iterator(Iterator& it, ptrdiff_t n, cudlb::bidirectional_iterator_tag)
+	{
+		for (; n > 0; --n)
+			++it;
+		for (; n < 0; ++n)
+			--it;
+	}
+
+	template<typename Iterator>
+	__host__ __device__
+	void advance_iterator(Iterator& it, ptrdiff_t const n, cudlb::random_access_iterator_tag)
+	{
+		it += static_cast<typename cudlb::iterator_traits<Iterator>::difference_type>(n);
+	}
+
+	template<typename Iterator>
+	__host__ __device__
+	void advance(Iterator& it, ptrdiff_t const n)
+	{
+		cudlb::advance_iterator(it, n, typename cudlb::iterator_traits<Iterator>::iterator_category());
+	}
+
+	/**
+	*	Returns the number of increments from first to last, in constant time for random access iterators.
+	*/
+	template<typename Iterator>
+	__host__ __device__
+	typename cudlb::iterator_traits<Iterator>::difference_type distance(Iterator first, Iterator last)
+	{
+		using difference_type = typename cudlb::iterator_traits<Iterator>::difference_type;
+		return static_cast<difference_type>(cudlb::iterator_distance(first, last, typename cudlb::iterator_traits<Iterator>::iterator_category()));
+	}
+
+	/**
+	*	Returns the iterator n elements after it.
+	*/
+	template<typename Iterator>
+	__host__ __device__
+	Iterator next(Iterator it, ptrdiff_t const n = 1)
+	{
+		cudlb::advance(it, n);
+		return it;
+	}
+
+	/**
+	*	Returns the iterator n elements before it, requires a bidirectional iterator.
+	*/
+	template<typename Iterator>
+	__host__ __device__
+	Iterator prev(Iterator it, ptrdiff_t const n = 1)
+	{
+		cudlb::advance(it, -n);
+		return it;
+	}
+
+	/**
+	*	Returns the address of the element a contiguous iterator refers to, without dereferencing it,
+	*	so it is also defined for the end of a range.
+	*/
+	template<typename T>
+	__host__ __device__
+	T* to_address(T* p)
+	{
+		return p;
+	}
+
+	template<typename Iterator>
+	__host__ __device__
+	auto to_address(Iterator const& it) -> decltype(it.operator->())
+	{
+		return it.operator->();
+	}
+}
@@ -0,0 +1,506 @@
+#pragma once
+#include "device_execution.h"
+#include "device_type_traits.h"
+
+namespace cudlb
+{
+	/**
+	*	Function object returning its argument unchanged, the transformation of a plain reduction.
+	*/
+	struct identity {
+		template<typename T>
+		__host__ __device__
+		T&& operator()(T&& arg) const
+		{
+			return static_cast<T&&>(arg);
+		}
+	};
+
+	/**
+	*	Transforms the elements of a range and combines the results with a binary operation.
+	*	@[first : last) - range of elements.
+	*	@init - initial value of the result.
+	*	@reduce - associative binary operation combining the result with a transformed element.
+	*	@transform - unary operation applied to each element.
+	*	Returns init combined with the transformed elements, in order.
+	*/
+	template<typename Iterator, typename T, typename BinaryOp, typename UnaryOp>
+	__host__ __device__
+	T transform_reduce(Iterator first, Iterator last, T init, BinaryOp reduce, UnaryOp transform)
+	{
+		for (; first != last; ++first)
+			init = reduce(init, transform(*first));
+		return init;
+	}
+
+	/**
+	*	Combines the pairs of elements of two ranges with a binary transformation and reduces the results.
+	*	@[first_a : last_a) - first range of elements.
+	*	@first_b - start of the second range, at least as long as the first.
+	*	@init - initial value of the result.
+	*	@reduce - associative binary operation combining the result with a transformed pair.
+	*	@transform - binary operation applied to each pair of elements.
+	*/
+	template<typename IteratorA, typename IteratorB, typename T, typename BinaryReduce, typename BinaryTransform>
+	__host__ __device__
+	T transform_reduce(IteratorA first_a, IteratorA last_a, IteratorB first_b, T init, BinaryReduce reduce, BinaryTransform transform)
+	{
+		for (; first_a != last_a; ++first_a, ++first_b)
+			init = reduce(init, transform(*first_a, *first_b));
+		return init;
+	}
+
+	/**
+	*	Returns the inner product of two ranges, added to @init.
+	*/
+	template<typename IteratorA, typename IteratorB, typename T>
+	__host__ __device__
+	T transform_reduce(IteratorA first_a, IteratorA last_a, IteratorB first_b, T init)
+	{
+		return cudlb::transform_reduce(first_a, last_a, first_b, init, cudlb::plus<T>(), cudlb::multiplies<T>());
+	}
+
+	/**
+	*	Combines the elements of a range with a binary operation.
+	*	@[first : last) - range of elements.
+	*	@init - initial value of the result.
+	*	@op - associative binary operation.
+	*/
+	template<typename Iterator, typename T, typename BinaryOp>
+	__host__ __device__
+	T reduce(Iterator first, Iterator last, T init, BinaryOp op)
+	{
+		return cudlb::transform_reduce(first, last, init, op, cudlb::identity());
+	}
+
+	/**
+	*	Returns the sum of the elements of a range, added to @init.
+	*/
+	template<typename Iterator, typename T>
+	__host__ __device__
+	T reduce(Iterator first, Iterator last, T init)
+	{
+		return cudlb::reduce(first, last, init, cudlb::plus<T>());
+	}
+
+	/**
+	*	Computes the running results of a binary operation over a range, the i-th output includes the i-th element.
+	*	@[first : last) - range of elements.
+	*	@out - start of the output range, may be equal to @first.
+	*	@op - associative binary operation.
+	*	@init - value combined before the first element.
+	*	Returns an iterator past the last output.
+	*/
+	template<typename InputIterator, typename OutputIterator, typename BinaryOp, typename T>
+	__host__ __device__
+	OutputIterator inclusive_scan(InputIterator first, InputIterator last, OutputIterator out, BinaryOp op, T init)
+	{
+		for (; first != last; ++first, ++out)
+		{
+			init = op(init, *first);
+			*out = init;
+		}
+		return out;
+	}
+
+	template<typename InputIterator, typename OutputIterator, typename BinaryOp>
+	__host__ __device__
+	OutputIterator inclusive_scan(InputIterator first, InputIterator last, OutputIterator out, BinaryOp op)
+	{
+		using value_type = typename cudlb::remove_cv<typename cudlb::remove_reference<decltype(*first)>::value_type>::value_type;
+		if (first == last) return out;
+		value_type const head = *first;
+		*out = head;
+		return cudlb::inclusive_scan(++first, last, ++out, op, head);
+	}
+
+	template<typename InputIterator, typename OutputIterator>
+	__host__ __device__
+	OutputIterator inclusive_scan(InputIterator first, InputIterator last, OutputIterator out)
+	{
+		using value_type = typename cudlb::remove_cv<typename cudlb::remove_reference<decltype(*first)>::value_type>::value_type;
+		return cudlb::inclusive_scan(first, last, out, cudlb::plus<value_type>());
+	}
+
+	/**
+	*	Computes the running results of a binary operation over a range, the i-th output excludes the i-th element.
+	*	@[first : last) - range of elements.
+	*	@out - start of the output range, may be equal to @first.
+	*	@init - first output, combined before the first element.
+	*	@op - associative binary operation.
+	*	Returns an iterator past the last output.
+	*/
+	template<typename InputIterator, typename OutputIterator, typename T, typename BinaryOp>
+	__host__ __device__
+	OutputIterator exclusive_scan(InputIterator first, InputIterator last, OutputIterator out, T init, BinaryOp op)
+	{
+		for (; first != last; ++first, ++out)
+		{
+			T next = op(init, *first);
+			*out = init;
+			init = next;
+		}
+		return out;
+	}
+
+	template<typename InputIterator, typename OutputIterator, typename T>
+	__host__ __device__
+	OutputIterator exclusive_scan(InputIterator first, InputIterator last, OutputIterator out, T init)
+	{
+		return cudlb::exclusive_scan(first, last, out, init, cudlb::plus<T>());
+	}
+
+	/**
+	*	Parallel cudlb::transform_reduce.
+	*	Every tile reduces its elements into a partial result, the partial results are then combined in tile order.
+	*	@reduce must be associative, the elements are combined in a different grouping than by the serial version.
+	*/
+	template<typename Iterator, typename T, typename BinaryOp, typename UnaryOp>
+	__host__ __device__
+	T tiled_transform_reduce(Iterator first, Iterator last, T init, BinaryOp reduce, UnaryOp transform, cudlb::true_type)
+	{
+		cudlb::tiling const tiles = cudlb::make_tiling(static_cast<size_t>(last - first));
+		if (tiles.tiles == 1) return cudlb::transform_reduce(first, last, init, reduce, transform);
+
+		cudlb::tile_buffer<T> partial{ tiles.tiles };
+		cudlb::parallel_for(tiles.tiles, [&](size_t const t) {
+			Iterator it = first + tiles.begin(t);
+			T acc = transform(*it);
+			partial.construct(t, cudlb::transform_reduce(++it, first + tiles.end(t), acc, reduce, transform));
+		});
+		for (size_t t = 0; t != tiles.tiles; ++t)
+			init = reduce(init, partial[t]);
+		return init;
+	}
+
+	template<typename Iterator, typename T, typename BinaryOp, typename UnaryOp>
+	__host__ __device__
+	T tiled_transform_reduce(Iterator first, Iterator last, T init, BinaryOp reduce, UnaryOp transform, cudlb::false_type)
+	{
+		return cudlb::transform_reduce(first, last, init, reduce, transform);
+	}
+
+	template<typename Iterator, typename T, typename BinaryOp, typename UnaryOp>
+	__host__ __device__
+	T transform_reduce(cudlb::parallel_policy, Iterator first, Iterator last, T init, BinaryOp reduce, UnaryOp transform)
+	{
+		return cudlb::tiled_transform_reduce(first, last, init, reduce, transform, cudlb::parallel_iterators<Iterator>());
+	}
+
+	/**
+	*	Parallel binary cudlb::transform_reduce, tiled like the unary version.
+	*/
+	template<typename IteratorA, typename IteratorB, typename T, typename BinaryReduce, typename BinaryTransform>
+	__host__ __device__
+	T tiled_transform_reduce(IteratorA first_a, IteratorA last_a, IteratorB first_b, T init, BinaryReduce reduce, BinaryTransform transform, cudlb::true_type)
+	{
+		cudlb::tiling const tiles = cudlb::make_tiling(static_cast<size_t>(last_a - first_a));
+		if (tiles.tiles == 1) return cudlb::transform_reduce(first_a, last_a, first_b, init, reduce, transform);
+
+		cudlb::tile_buffer<T> partial{ tiles.tiles };
+		cudlb::parallel_for(tiles.tiles, [&](size_t const t) {
+			IteratorA a = first_a + tiles.begin(t);
+			IteratorB b = first_b + tiles.begin(t);
+			T acc = transform(*a, *b);
+			partial.construct(t, cudlb::transform_reduce(++a, first_a + tiles.end(t), ++b, acc, reduce, transform));
+		});
+		for (size_t t = 0; t != tiles.tiles; ++t)
+			init = reduce(init, partial[t]);
+		return init;
+	}
+
+	template<typename IteratorA, typename IteratorB, typename T, typename BinaryReduce, typename BinaryTransform>
+	__host__ __device__
+	T tiled_transform_reduce(IteratorA first_a, IteratorA last_a, IteratorB first_b, T init, BinaryReduce reduce, BinaryTransform transform, cudlb::false_type)
+	{
+		return cudlb::transform_reduce(first_a, last_a, first_b, init, reduce, transform);
+	}
+
+	template<typename IteratorA, typename IteratorB, typename T, typename BinaryReduce, typename BinaryTransform>
+	__host__ __device__
+	T transform_reduce(cudlb::parallel_policy, IteratorA first_a, IteratorA last_a, IteratorB first_b, T init, BinaryReduce reduce, BinaryTransform transform)
+	{
+		return cudlb::tiled_transform_reduce(first_a, last_a, first_b, init, reduce, transform, cudlb::parallel_iterators<IteratorA, IteratorB>());
+	}
+
+	template<typename IteratorA, typename IteratorB, typename T>
+	__host__ __device__
+	T transform_reduce(cudlb::parallel_policy policy, IteratorA first_a, IteratorA last_a, IteratorB first_b, T init)
+	{
+		return cudlb::transform_reduce(policy, first_a, last_a, first_b, init, cudlb::plus<T>(), cudlb::multiplies<T>());
+	}
+
+	/**
+	*	Parallel cudlb::reduce, @op must be associative.
+	*/
+	template<typename Iterator, typename T, typename BinaryOp>
+	__host__ __device__
+	T reduce(cudlb::parallel_policy policy, Iterator first, Iterator last, T init, BinaryOp op)
+	{
+		return cudlb::transform_reduce(policy, first, last, init, op, cudlb::identity());
+	}
+
+	template<typename Iterator, typename T>
+	__host__ __device__
+	T reduce(cudlb::parallel_policy policy, Iterator first, Iterator last, T init)
+	{
+		return cudlb::reduce(policy, first, last, init, cudlb::plus<T>());
+	}
+
+	/**
+	*	Tiled scan shared by the parallel inclusive and exclusive scans, in three passes:
+	*	every tile reduces its elements into a tile sum, the tile sums are scanned serially into the value carried
+	*	into each tile, then every tile scans its elements starting from its carry.
+	*	Tiles write only their own outputs, so the output may alias the input.
+	*/
+	template<typename InputIterator, typename OutputIterator, typename T, typename BinaryOp>
+	__host__ __device__
+	OutputIterator tiled_scan(InputIterator first, InputIterator last, OutputIterator out, T init, BinaryOp op, bool const inclusive, cudlb::true_type)
+	{
+		size_t const n = static_cast<size_t>(last - first);
+		cudlb::tiling const tiles = cudlb::make_tiling(n);
+		if (tiles.tiles == 1)
+		{
+			return inclusive ? cudlb::inclusive_scan(first, last, out, op, init) : cudlb::exclusive_scan(first, last, out, init, op);
+		}
+
+		cudlb::tile_buffer<T> sums{ tiles.tiles };
+		cudlb::parallel_for(tiles.tiles, [&](size_t const t) {
+			InputIterator it = first + tiles.begin(t);
+			T acc = *it;
+			sums.construct(t, cudlb::reduce(++it, first + tiles.end(t), acc, op));
+		});
+
+		cudlb::tile_buffer<T> carry{ tiles.tiles };
+		carry.construct(0, init);
+		for (size_t t = 1; t != tiles.tiles; ++t)
+			carry.construct(t, op(carry[t - 1], sums[t - 1]));
+
+		cudlb::parallel_for(tiles.tiles, [&](size_t const t) {
+			InputIterator const tile_first = first + tiles.begin(t);
+			InputIterator const tile_last = first + tiles.end(t);
+			OutputIterator const tile_out = out + tiles.begin(t);
+			if (inclusive) cudlb::inclusive_scan(tile_first, tile_last, tile_out, op, carry[t]);
+			else cudlb::exclusive_scan(tile_first, tile_last, tile_out, carry[t], op);
+		});
+		return out + n;
+	}
+
+	template<typename InputIterator, typename OutputIterator, typename T, typename BinaryOp>
+	__host__ __device__
+	OutputIterator tiled_scan(InputIterator first, InputIterator last, OutputIterator out, T init, BinaryOp op, bool const inclusive, cudlb::false_type)
+	{
+		return inclusive ? cudlb::inclusive_scan(first, last, out, op, init) : cudlb::exclusive_scan(first, last, out, init, op);
+	}
+
+	/**
+	*	Parallel cudlb::inclusive_scan over random access ranges, @op must be associative.
+	*/
+	template<typename InputIterator, typename OutputIterator, typename BinaryOp, typename T>
+	__host__ __device__
+	OutputIterator inclusive_scan(cudlb::parallel_policy, InputIterator first, InputIterator last, OutputIterator out, BinaryOp op, T init)
+	{
+		return cudlb::tiled_scan(first, last, out, init, op, true, cudlb::parallel_iterators<InputIterator, OutputIterator>());
+	}
+
+	template<typename InputIterator, typename OutputIterator, typename BinaryOp>
+	__host__ __device__
+	OutputIterator inclusive_scan(cudlb::parallel_policy policy, InputIterator first, InputIterator last, OutputIterator out, BinaryOp op)
+	{
+		using value_type = typename cudlb::remove_cv<typename cudlb::remove_reference<decltype(*first)>::value_type>::value_type;
+		if (first == last) return out;
+		value_type const head = *first;
+		*out = head;
+		return cudlb::inclusive_scan(policy, ++first, last, ++out, op, head);
+	}
+
+	template<typename InputIterator, typename OutputIterator>
+	__host__ __device__
+	OutputIterator inclusive_scan(cudlb::parallel_policy policy, InputIterator first, InputIterator last, OutputIterator out)
+	{
+		using value_type = typename cudlb::remove_cv<typename cudlb::remove_reference<decltype(*first)>::value_type>::value_type;
+		return cudlb::inclusive_scan(policy, first, last, out, cudlb::plus<value_type>());
+	}
+
+	/**
+	*	Parallel cudlb::exclusive_scan over random access ranges, @op must be associative.
+	*/
+	template<typename InputIterator, typename OutputIterator, typename T, typename BinaryOp>
+	__host__ __device__
+	OutputIterator exclusive_scan(cudlb::parallel_policy, InputIterator first, InputIterator last, OutputIterator out, T init, BinaryOp op)
+	{
+		return cudlb::tiled_scan(first, last, out, init, op, false, cudlb::parallel_iterators<InputIterator, OutputIterator>());
+	}
+
+	template<typename InputIterator, typename OutputIterator, typename T>
+	__host__ __device__
+	OutputIterator exclusive_scan(cudlb::parallel_policy policy, InputIterator first, InputIterator last, OutputIterator out, T init)
+	{
+		return cudlb::exclusive_scan(policy, first, last, out, init, cudlb::plus<T>());
+	}
+
+	/**
+	*	Maps an integral value to its own bin, values outside [0 : nbins) to the discard bin nbins.
+	*/
+	struct histogram_bin {
+		size_t nbins;
+
+		template<typename T>
+		__host__ __device__
+		size_t operator()(T const& value) const
+		{
+			// Negative values convert to very large ones and are discarded too.
+			size_t const b = static_cast<size_t>(value);
+			return b < nbins ? b : nbins;
+		}
+	};
+
+	/**
+	*	Maps a value to one of nbins bins of equal width covering [lower : upper), other values and NaNs
+	*	to the discard bin nbins.
+	*/
+	template<typename T>
+	struct histogram_even_bin {
+		T lower;
+		T upper;
+		T scale;	// nbins / (upper - lower)
+		size_t nbins;
+
+		template<typename U>
+		__host__ __device__
+		size_t operator()(U const& value) const
+		{
+			T const v = static_cast<T>(value);
+			if (!(v >= lower && v < upper)) return nbins;
+			// Rounding can put values just below upper into bin nbins.
+			size_t const b = static_cast<size_t>((v - lower) * scale);
+			return b < nbins ? b : nbins - 1;
+		}
+	};
+
+	/**
+	*	Returns the bin mapping of histogram_even for elements of type V. The bin arithmetic is done in V if it is
+	*	a floating point type and in double otherwise, so integral bounds or elements never truncate the bin width.
+	*/
+	template<typename V, typename T>
+	__host__ __device__
+	cudlb::histogram_even_bin<typename cudlb::conditional<cudlb::is_floating_point<V>::value, V, double>::type>
+		make_histogram_even_bin(T const lower, T const upper, size_t const nbins)
+	{
+		using real = typename cudlb::conditional<cudlb::is_floating_point<V>::value, V, double>::type;
+		real const lo = static_cast<real>(lower);
+		real const hi = static_cast<real>(upper);
+		return { lo, hi, static_cast<real>(nbins) / (hi - lo), nbins };
+	}
+
+	/**
+	*	Histogram shared by the serial and parallel versions.
+	*	Every tile counts its elements into private bins, so that no counter is shared between tiles,
+	*	then the private bins are summed bin by bin into @bins.
+	*	Up to 1024 bins, each tile keeps 4 copies of its bins, used by consecutive elements in turn,
+	*	so that runs of equal elements increment 4 independent counters instead of waiting on one.
+	*	Every copy holds an extra discard bin which takes the elements outside the histogram without a branch.
+	*	The private bins never take more counters than there are elements, unless a single copy does: the copies
+	*	are dropped and then the tiles reduced until they fit, so a histogram with many bins runs on fewer tiles.
+	*/
+	template<typename Iterator, typename OutputIterator, typename Bin>
+	__host__ __device__
+	void tiled_histogram(Iterator first, OutputIterator bins, size_t const nbins, Bin bin, cudlb::tiling const& requested)
+	{
+		size_t const stride = nbins + 1;
+		size_t const copies = nbins <= 1024 && 4 * stride <= requested.n ? 4 : 1;
+		size_t const per_tile = copies * stride;
+		size_t const max_tiles = requested.n / per_tile == 0 ? 1 : requested.n / per_tile;
+		cudlb::tiling const tiles{ requested.n, requested.tiles < max_tiles ? requested.tiles : max_tiles };
+
+		cudlb::tile_buffer<size_t> counts{ tiles.tiles * per_tile };
+		cudlb::parallel_for(tiles.tiles, [&](size_t const t) {
+			for (size_t i = t * per_tile; i != (t + 1) * per_tile; ++i)
+				counts.construct(i, 0);
+			size_t* const c = &counts[t * per_tile];
+			Iterator const it = first + tiles.begin(t);
+			size_t const n = tiles.end(t) - tiles.begin(t);
+			size_t i = 0;
+			if (copies == 4)
+			{
+				for (; i + 4 <= n; i += 4)
+				{
+					++c[bin(it[i])];
+					++c[stride + bin(it[i + 1])];
+					++c[2 * stride + bin(it[i + 2])];
+					++c[3 * stride + bin(it[i + 3])];
+				}
+			}
+			for (; i != n; ++i)
+				++c[bin(it[i])];
+		});
+
+		size_t const sources = tiles.tiles * copies;
+		cudlb::tiling const bin_tiles = cudlb::make_tiling(nbins);
+		cudlb::parallel_for(bin_tiles.tiles, [&](size_t const t) {
+			for (size_t b = bin_tiles.begin(t); b != bin_tiles.end(t); ++b)
+			{
+				size_t sum = 0;
+				for (size_t k = 0; k != sources; ++k)
+					sum += counts[k * stride + b];
+				bins[b] = sum;
+			}
+		});
+	}
+
+	/**
+	*	Counts the elements of a range which fall into each bin, an element of value v falls into bin v.
+	*	Suited to bytes and small integer codes, elements outside [0 : nbins) are not counted.
+	*	@[first : last) - random access range of integral elements.
+	*	@bins - start of a random access range of nbins counters, overwritten with the counts.
+	*	@nbins - number of bins.
+	*	NOTE: Bytes should be given as unsigned char, negative signed char values are not counted.
+	*/
+	template<typename Iterator, typename OutputIterator>
+	__host__ __device__
+	void histogram(Iterator first, Iterator last, OutputIterator bins, size_t const nbins)
+	{
+		cudlb::tiled_histogram(first, bins, nbins, cudlb::histogram_bin{ nbins }, cudlb::tiling{ static_cast<size_t>(last - first), 1 });
+	}
+
+	/**
+	*	Parallel cudlb::histogram, tiles count into private bins which are summed in parallel at the end.
+	*/
+	template<typename Iterator, typename OutputIterator>
+	__host__ __device__
+	void histogram(cudlb::parallel_policy, Iterator first, Iterator last, OutputIterator bins, size_t const nbins)
+	{
+		cudlb::tiled_histogram(first, bins, nbins, cudlb::histogram_bin{ nbins }, cudlb::make_tiling(static_cast<size_t>(last - first)));
+	}
+
+	/**
+	*	Counts the elements of a range which fall into each of nbins bins of equal width covering [lower : upper).
+	*	@[first : last) - random access range of elements.
+	*	@bins - start of a random access range of nbins counters, overwritten with the counts.
+	*	@nbins - number of bins, at least 1.
+	*	@lower - lower bound of the first bin, included.
+	*	@upper - upper bound of the last bin, excluded.
+	*	NOTE: Elements outside [lower : upper) and NaNs are not counted. The bins are computed in the element type
+	*	if it is a floating point type and in double otherwise, whatever the type of the bounds.
+	*/
+	template<typename Iterator, typename OutputIterator, typename T>
+	__host__ __device__
+	void histogram_even(Iterator first, Iterator last, OutputIterator bins, size_t const nbins, T const lower, T const upper)
+	{
+		using value_type = typename cudlb::remove_cv<typename cudlb::remove_reference<decltype(*first)>::value_type>::value_type;
+		auto const bin = cudlb::make_histogram_even_bin<value_type>(lower, upper, nbins);
+		cudlb::tiled_histogram(first, bins, nbins, bin, cudlb::tiling{ static_cast<size_t>(last - first), 1 });
+	}
+
+	/**
+	*	Parallel cudlb::histogram_even.
+	*/
+	template<typename Iterator, typename OutputIterator, typename T>
+	__host__ __device__
+	void histogram_even(cudlb::parallel_policy, Iterator first, Iterator last, OutputIterator bins, size_t const nbins, T const lower, T const upper)
+	{
+		using value_type = typename cudlb::remove_cv<typename cudlb::remove_reference<decltype(*first)>::value_type>::value_type;
+		auto const bin = cudlb::make_histogram_even_bin<value_type>(lower, upper, nbins);
+		cudlb::tiled_histogram(first, bins, nbins, bin, cudlb::make_tiling(static_cast<size_t>(last - first)));
+	}
+}
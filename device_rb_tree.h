@@ -2,6 +2,7 @@
 #include "device_utility.h"
 #include "device_allocator.h"
 #include "device_type_traits.h"
+#include "device_iterator.h"
 
 namespace cudlb 
 {
@@ -9,41 +10,100 @@ namespace cudlb
 		black, red
 	};
 
-	template<typename T> 
-	struct rb_tree_node {
-		using node = rb_tree_node;
-		using value = T; 
-		
+	/**
+	*	Node orders rb_tree::compact() can lay the tree out in.
+	*	breadth_first - level by level, the top levels of every lookup share a few cache lines.
+	*	van_emde_boas - recursively split into a top half and bottom subtrees, each stored contiguously,
+	*	a lookup touches O(log_B n) cache lines for any cache line size B.
+	*	in_order - ascending value order, iteration and for_each_inorder become sequential scans.
+	*/
+	enum class rb_tree_layout {
+		breadth_first, van_emde_boas, in_order
+	};
+
+	/**
+	*	Augmentation policies for rb_tree, selected by the Augment template parameter.
+	*	rb_tree_plain - nodes carry no extra data.
+	*	rb_tree_order_statistic - nodes carry the size of their subtree, which enables select(), rank() and count_range().
+	*/
+	struct rb_tree_plain {};
+	struct rb_tree_order_statistic {};
+
+	/**
+	*	Per node data of an augmentation policy, rb_tree_node derives from it.
+	*	The unaugmented version is empty and all of its hooks compile to nothing.
+	*/
+	template<typename Augment>
+	struct rb_tree_node_augment {
+		static constexpr bool enabled = false;
+
 		__device__
-		rb_tree_node()
-			: val{ value() }, parent{ nullptr }, left{ nullptr }, right{ nullptr }, colour{ rb_tree_colour::black }
-		{}
+		void reset() {}
 
 		__device__
-		explicit rb_tree_node(value const& val)
-			: val{ val }, parent{ nullptr }, left{ nullptr }, right{ nullptr }, colour{ rb_tree_colour::black }
+		void grow() {}
+
+		__device__
+		void update(rb_tree_node_augment const&, rb_tree_node_augment const&) {}
+	};
+
+	template<>
+	struct rb_tree_node_augment<rb_tree_order_statistic> {
+		static constexpr bool enabled = true;
+
+		__device__
+		rb_tree_node_augment()
+			: size{ 0 }
 		{}
 
+		/**
+		*	Called on a node which is about to be linked in as a new leaf.
+		*/
 		__device__
-		node* min(node* nd)
+		void reset()
 		{
-			while (nd->left)
-			{
-				nd = nd->left;
-			}
-			return nd; 
+			size = 1;
 		}
 
+		/**
+		*	Called on every node on the path of an insertion, before the new node is linked in.
+		*/
 		__device__
-		node* max(node* nd)
+		void grow()
 		{
-			while (nd->right)
-			{
-				nd = nd->right;
-			}
-			return nd; 
+			++size;
 		}
 
+		/**
+		*	Recomputes the node data from the data of its children.
+		*	@left - left child of the node.
+		*	@right - right child of the node.
+		*/
+		__device__
+		void update(rb_tree_node_augment const& left, rb_tree_node_augment const& right)
+		{
+			size = left.size + right.size + 1;
+		}
+
+		size_t size;	// Number of nodes in the subtree rooted at this node, the sentinel has size 0.
+	};
+
+	template<typename T, typename Augment = rb_tree_plain> 
+	struct rb_tree_node : rb_tree_node_augment<Augment> {
+		using node = rb_tree_node;
+		using value = T; 
+		using augment = rb_tree_node_augment<Augment>;
+		
+		__device__
+		rb_tree_node()
+			: val{ value() }, parent{ nullptr }, left{ nullptr }, right{ nullptr }, colour{ rb_tree_colour::black }
+		{}
+
+		__device__
+		explicit rb_tree_node(value const& val)
+			: val{ val }, parent{ nullptr }, left{ nullptr }, right{ nullptr }, colour{ rb_tree_colour::black }
+		{}
+
 		value val; 
 		node* parent; 
 		node* left; 
@@ -51,34 +111,50 @@ namespace cudlb
 		rb_tree_colour colour; 
 	};
 
-	template<typename T, typename Comp = cudlb::less<T>, typename Allocator = cudlb::device_allocator<rb_tree_node<T>>>
+	template<typename T, typename Comp = cudlb::less<T>, typename Allocator = cudlb::device_allocator<rb_tree_node<T>>, typename Augment = rb_tree_plain>
 	class rb_tree {
 	public:
-		using node = rb_tree_node<T>;
+		using node = rb_tree_node<T, Augment>;
 		using value = T;
+		using size_type = size_t;
+		using node_allocator = typename Allocator::template rebind<node>::other;
 		
 		struct iterator; 
 		struct const_iterator;
+		using reverse_iterator = cudlb::reverse_iterator<iterator>;
+		using const_reverse_iterator = cudlb::reverse_iterator<const_iterator>;
 
+		/**
+		*	Tree implementation. 
+		*	@sentinel - the shared black leaf of the tree, every missing child and the parent of the root point to it.
+		*	@begin - leftmost node, kept up to date by insert and remove so that begin() is O(1).
+		*	@rbegin - rightmost node, kept up to date by insert and remove so that rbegin() is O(1).
+		*	@pool - contiguous block the nodes were moved into by the last compact(), nullptr if there was none.
+		*	NOTE: end() is the sentinel, which makes the tree address dependent, rb_tree objects cannot be copied.
+		*/
 		struct rb_tree_impl {
 
 			__device__
 			rb_tree_impl()
-				: root{ nullptr }, begin{ nullptr }, end{ nullptr }
+				: root{ &sentinel }, begin{ &sentinel }, rbegin{ &sentinel }, end{ &sentinel }, pool{ nullptr }, pool_size{ 0 }
 			{
 			}
 
 			__device__
 			rb_tree_impl(Comp const& c_other, Allocator const& a_other)
-				: comp{ c_other }, alloc{ a_other }, root{ nullptr }, begin{ nullptr }, end{ nullptr }
+				: comp{ c_other }, alloc{ a_other }, root{ &sentinel }, begin{ &sentinel }, rbegin{ &sentinel }, end{ &sentinel }, pool{ nullptr }, pool_size{ 0 }
 			{
 			}
 
 			Comp comp;
-			Allocator alloc;
+			node_allocator alloc;
+			node sentinel;
 			node* root;
 			node* begin; 
+			node* rbegin;
 			node* end;
+			node* pool;
+			size_type pool_size;
 		};
 
 		__device__
@@ -97,8 +173,117 @@ namespace cudlb
 		explicit rb_tree(value const& val)
 			: impl{}
 		{
-			impl.root = impl.begin = impl.alloc.allocate();
-			impl.alloc.construct(impl.root, val);
+			insert(val);
+		}
+
+		rb_tree(rb_tree const&) = delete;
+
+		rb_tree const& operator=(rb_tree const&) = delete;
+
+		/**
+		*	Allocates a new node holding @val and links it into the tree. 
+		*	@val - value to insert, equal values are kept in insertion order.
+		*	Returns an iterator to the new node.
+		*/
+		__device__
+		iterator insert(value const& val)
+		{
+			node* z = impl.alloc.allocate();
+			impl.alloc.construct(z, val);
+			insert(z);
+			return iterator{ z, &impl };
+		}
+
+		/**
+		*	Unlinks the node an iterator points to and returns its space to the allocator. 
+		*	@pos - iterator to the node to erase, must not be end().
+		*/
+		__device__
+		void erase(iterator pos)
+		{
+			remove(pos.nd);
+			release(pos.nd);
+		}
+
+		/**
+		*	Moves all nodes into one fresh contiguous allocation, in an order chosen for the expected access pattern.
+		*	Links are rewritten to the new addresses and the old node storage is returned to the allocator.
+		*	@layout - order of the nodes in the new allocation.
+		*	NOTE: Restores the locality lost to long insert and erase churn. All iterators are invalidated.
+		*	Nodes inserted afterwards are allocated individually until the next call.
+		*/
+		__device__
+		void compact(rb_tree_layout layout = rb_tree_layout::van_emde_boas)
+		{
+			size_type const n = count_nodes();
+			node* const old_pool = impl.pool;
+			size_type const old_pool_size = impl.pool_size;
+			if (n == 0)
+			{
+				impl.pool = nullptr;
+				impl.pool_size = 0;
+				impl.alloc.deallocate(old_pool, old_pool_size);
+				return;
+			}
+
+			typename Allocator::template rebind<node*>::other scratch{ impl.alloc };
+			node** order = scratch.allocate(n);
+			if (layout == rb_tree_layout::breadth_first)
+			{
+				size_type tail = 0;
+				order[tail++] = impl.root;
+				for (size_type head = 0; head != tail; ++head)
+				{
+					if (order[head]->left != impl.end) order[tail++] = order[head]->left;
+					if (order[head]->right != impl.end) order[tail++] = order[head]->right;
+				}
+			}
+			else if (layout == rb_tree_layout::van_emde_boas)
+			{
+				size_type pos = 0;
+				veb_order(impl.root, height(), order, pos);
+			}
+			else
+			{
+				size_type pos = 0;
+				for_each_node_inorder([&](node* x) { order[pos++] = x; });
+			}
+
+			// Move every node to its new slot and leave the new address in the old node's parent link.
+			node* fresh = impl.alloc.allocate(n);
+			for (size_type i = 0; i != n; ++i)
+			{
+				impl.alloc.construct(fresh + i, cudlb::move(*order[i]));
+				order[i]->parent = fresh + i;
+			}
+			// Redirect the child links through the forwarding addresses, parents are set from the child's side.
+			for (size_type i = 0; i != n; ++i)
+			{
+				node* x = fresh + i;
+				if (x->left != impl.end)
+				{
+					x->left = x->left->parent;
+					x->left->parent = x;
+				}
+				if (x->right != impl.end)
+				{
+					x->right = x->right->parent;
+					x->right->parent = x;
+				}
+			}
+			impl.root = impl.root->parent;
+			impl.root->parent = impl.end;
+			impl.begin = impl.begin->parent;
+			impl.rbegin = impl.rbegin->parent;
+
+			for (size_type i = 0; i != n; ++i)
+			{
+				release(order[i]);
+			}
+			impl.alloc.deallocate(old_pool, old_pool_size);
+			scratch.deallocate(order, n);
+			impl.pool = fresh;
+			impl.pool_size = n;
 		}
 
 		__device__ 
@@ -110,6 +295,7 @@ namespace cudlb
 			while (x != impl.end)
 			{
 				y = x; 
+				x->grow();
 				if (impl.comp(z->val, x->val))
 				{
 					x = x->left;
@@ -135,12 +321,32 @@ namespace cudlb
 			z->left = impl.end; 
 			z->right = impl.end; 
 			z->colour = rb_tree_colour::red;
+			// Equal values go right, so a new value equal to the minimum is not the leftmost node but one equal to the maximum is the rightmost.
+			if (impl.begin == impl.end || impl.comp(z->val, impl.begin->val))
+			{
+				impl.begin = z;
+			}
+			if (impl.rbegin == impl.end || !impl.comp(z->val, impl.rbegin->val))
+			{
+				impl.rbegin = z;
+			}
+			z->reset();
 			insert_fixup(z);
 		}
 
 		__device__
 		void remove(node* z)
 		{
+			// The leftmost node has no left child, its successor is the minimum of its right subtree or else its parent.
+			if (z == impl.begin)
+			{
+				impl.begin = z->right != impl.end ? minimum(z->right) : z->parent;
+			}
+			if (z == impl.rbegin)
+			{
+				impl.rbegin = z->left != impl.end ? maximum(z->left) : z->parent;
+			}
+
 			node* x = impl.end;
 			node* y = z; 
 			rb_tree_colour y_temp = y->colour;
@@ -156,7 +362,7 @@ namespace cudlb
 			}
 			else
 			{
-				y = impl.root->min(z->right);
+				y = minimum(z->right);
 				y_temp = y->colour;
 				x = y->right;
 				if (y->parent == z)
@@ -174,6 +380,14 @@ namespace cudlb
 				y->left->parent = y;
 				y->colour = z->colour;
 			}
+			if (node::augment::enabled)
+			{
+				// Every node whose subtree lost z lies on the path from x up to the root.
+				for (node* p = x->parent; p != impl.end; p = p->parent)
+				{
+					p->update(*p->left, *p->right);
+				}
+			}
 			if (y_temp == rb_tree_colour::black)
 			{
 				remove_fixup(x);
@@ -181,7 +395,7 @@ namespace cudlb
 		}
 
 		__device__
-			void transplant(node* x, node* y)
+		void transplant(node* x, node* y)
 		{
 			if (x->parent == impl.end)
 			{
@@ -201,7 +415,7 @@ namespace cudlb
 		__device__
 		void remove_fixup(node* x)
 		{
-			while (x != impl.end && x->colour == rb_tree_colour::black)
+			while (x != impl.root && x->colour == rb_tree_colour::black)
 			{
 				if (x == x->parent->left)
 				{
@@ -218,18 +432,21 @@ namespace cudlb
 						y->colour = rb_tree_colour::red;
 						x = x->parent;
 					}
-					else if (y->right->colour == rb_tree_colour::black)
+					else
 					{
-						y->left->colour = rb_tree_colour::black;
-						y->colour = rb_tree_colour::red;
-						right_rotate(y);
-						y = x->parent->right;
+						if (y->right->colour == rb_tree_colour::black)
+						{
+							y->left->colour = rb_tree_colour::black;
+							y->colour = rb_tree_colour::red;
+							right_rotate(y);
+							y = x->parent->right;
+						}
+						y->colour = x->parent->colour;
+						x->parent->colour = rb_tree_colour::black;
+						y->right->colour = rb_tree_colour::black;
+						left_rotate(x->parent);
+						x = impl.root;
 					}
-					y->colour = x->parent->colour; 
-					x->parent->colour = rb_tree_colour::black;
-					y->right->colour = rb_tree_colour::black;
-					left_rotate(x->parent);
-					x = impl.root;
 				}
 				else
 				{
@@ -238,7 +455,7 @@ namespace cudlb
 					{
 						y->colour = rb_tree_colour::black;
 						x->parent->colour = rb_tree_colour::red;
-						left_rotate(x->parent);
+						right_rotate(x->parent);
 						y = x->parent->left;
 					}
 					if (y->right->colour == rb_tree_colour::black && y->left->colour == rb_tree_colour::black)
@@ -246,18 +463,21 @@ namespace cudlb
 						y->colour = rb_tree_colour::red;
 						x = x->parent;
 					}
-					else if (y->left->colour == rb_tree_colour::black)
+					else
 					{
-						y->right->colour = rb_tree_colour::black;
-						y->colour = rb_tree_colour::red;
-						right_rotate(y);
-						y = x->parent->left;
+						if (y->left->colour == rb_tree_colour::black)
+						{
+							y->right->colour = rb_tree_colour::black;
+							y->colour = rb_tree_colour::red;
+							left_rotate(y);
+							y = x->parent->left;
+						}
+						y->colour = x->parent->colour;
+						x->parent->colour = rb_tree_colour::black;
+						y->left->colour = rb_tree_colour::black;
+						right_rotate(x->parent);
+						x = impl.root;
 					}
-					y->colour = x->parent->colour;
-					x->parent->colour = rb_tree_colour::black;
-					y->left->colour = rb_tree_colour::black;
-					left_rotate(x->parent);
-					x = impl.root;
 				}
 			}
 			x->colour = rb_tree_colour::black;
@@ -278,14 +498,17 @@ namespace cudlb
 						z->parent->parent->colour = rb_tree_colour::red;
 						z = z->parent->parent;
 					}
-					else if (z == z->parent->right)
+					else
 					{
-						z = z->parent;
-						left_rotate(z);
+						if (z == z->parent->right)
+						{
+							z = z->parent;
+							left_rotate(z);
+						}
+						z->parent->colour = rb_tree_colour::black;
+						z->parent->parent->colour = rb_tree_colour::red;
+						right_rotate(z->parent->parent);
 					}
-					z->parent->colour = rb_tree_colour::black;
-					z->parent->parent->colour = rb_tree_colour::red;
-					right_rotate(z->parent->parent);
 				}
 				else 
 				{
@@ -297,14 +520,17 @@ namespace cudlb
 						z->parent->parent->colour = rb_tree_colour::red;
 						z = z->parent->parent;
 					}
-					else if (z == z->parent->left)
+					else
 					{
-						z = z->parent;
-						left_rotate(z);
+						if (z == z->parent->left)
+						{
+							z = z->parent;
+							right_rotate(z);
+						}
+						z->parent->colour = rb_tree_colour::black;
+						z->parent->parent->colour = rb_tree_colour::red;
+						left_rotate(z->parent->parent);
 					}
-					z->parent->colour = rb_tree_colour::black;
-					z->parent->parent->colour = rb_tree_colour::red;
-					right_rotate(z->parent->parent);
 				}
 			}
 			impl.root->colour = rb_tree_colour::black;
@@ -337,6 +563,8 @@ namespace cudlb
 				}
 				y->left = x;
 				x->parent = y;
+				x->update(*x->left, *x->right);
+				y->update(*y->left, *y->right);
 			}
 		}
 
@@ -352,7 +580,7 @@ namespace cudlb
 					x->right->parent = y;
 				}
 				x->parent = y->parent;
-				if (y == impl.end)
+				if (y->parent == impl.end)
 				{
 					impl.root = x;
 				}
@@ -366,25 +594,300 @@ namespace cudlb
 				}
 				x->right = y; 
 				y->parent = x;
+				y->update(*y->left, *y->right);
+				x->update(*x->left, *x->right);
 			}
 		}
 
+		/**
+		*	Returns the number of values in the tree.
+		*	NOTE: Only available with the rb_tree_order_statistic policy.
+		*/
+		__device__
+		size_type size() const
+		{
+			static_assert(node::augment::enabled, "rb_tree::size() requires the rb_tree_order_statistic policy");
+			return impl.root->size;
+		}
+
+		/**
+		*	Returns an iterator to the k-th smallest value, counting from 0.
+		*	@k - rank of the value to look for.
+		*	Returns end() if @k is not less than size().
+		*	NOTE: Only available with the rb_tree_order_statistic policy, runs in O(log n).
+		*/
+		__device__
+		iterator select(size_type const k)
+		{
+			return iterator{ select_node(k), &impl };
+		}
+
+		__device__
+		const_iterator select(size_type const k) const
+		{
+			return const_iterator{ select_node(k), &impl };
+		}
+
+		/**
+		*	Returns the number of values which are LESS than @key.
+		*	@key - value to rank.
+		*	NOTE: Only available with the rb_tree_order_statistic policy, runs in O(log n).
+		*/
+		__device__
+		size_type rank(value const& key) const
+		{
+			static_assert(node::augment::enabled, "rb_tree::rank() requires the rb_tree_order_statistic policy");
+			size_type r = 0;
+			node* x = impl.root;
+			while (x != impl.end)
+			{
+				if (impl.comp(x->val, key))
+				{
+					r += x->left->size + 1;
+					x = x->right;
+				}
+				else
+				{
+					x = x->left;
+				}
+			}
+			return r;
+		}
+
+		/**
+		*	Returns the number of values in the range [lo : hi).
+		*	@lo - inclusive lower bound of the range.
+		*	@hi - exclusive upper bound of the range.
+		*	NOTE: Only available with the rb_tree_order_statistic policy, runs in O(log n).
+		*/
+		__device__
+		size_type count_range(value const& lo, value const& hi) const
+		{
+			if (!impl.comp(lo, hi)) return 0;
+			return rank(hi) - rank(lo);
+		}
+
+		/**
+		*	Returns an iterator to the first value which is NOT LESS than @key, or end() if there is none.
+		*	@key - value to look for.
+		*/
+		__device__
+		iterator lower_bound(value const& key)
+		{
+			return iterator{ lower_bound_node(key), &impl };
+		}
+
+		__device__
+		const_iterator lower_bound(value const& key) const
+		{
+			return const_iterator{ lower_bound_node(key), &impl };
+		}
+
+		/**
+		*	Returns an iterator to the first value which is GREATER than @key, or end() if there is none.
+		*	@key - value to look for.
+		*/
+		__device__
+		iterator upper_bound(value const& key)
+		{
+			return iterator{ upper_bound_node(key), &impl };
+		}
+
+		__device__
+		const_iterator upper_bound(value const& key) const
+		{
+			return const_iterator{ upper_bound_node(key), &impl };
+		}
+
+		/**
+		*	Returns an iterator to the first value equal to @key, or end() if there is none.
+		*	@key - value to look for.
+		*/
+		__device__
+		iterator find(value const& key)
+		{
+			return iterator{ find_node(key), &impl };
+		}
+
+		__device__
+		const_iterator find(value const& key) const
+		{
+			return const_iterator{ find_node(key), &impl };
+		}
+
+		/**
+		*	Returns the range [lower_bound(key) : upper_bound(key)) of values equal to @key.
+		*	@key - value to look for.
+		*/
+		__device__
+		cudlb::pair<iterator, iterator> equal_range(value const& key)
+		{
+			return cudlb::pair<iterator, iterator>{ lower_bound(key), upper_bound(key) };
+		}
+
+		__device__
+		cudlb::pair<const_iterator, const_iterator> equal_range(value const& key) const
+		{
+			return cudlb::pair<const_iterator, const_iterator>{ lower_bound(key), upper_bound(key) };
+		}
+
+		/**
+		*	Looks up a sorted batch of keys, writing find(key) for each of them to @out. 
+		*	@[keys_first : keys_last) - keys to look for, sorted in ascending order.
+		*	@out - receives one iterator per key, end() for keys that are not in the tree.
+		*	Returns @out advanced past the last written iterator.
+		*	NOTE: The path of the previous descent is kept, each key only backs up to the deepest node whose
+		*	subtree can still hold it and descends from there, so the upper levels are not revisited per key.
+		*/
+		template<typename In, typename Out>
+		__device__
+		Out find_batch(In keys_first, In keys_last, Out out)
+		{
+			return find_batch_as<iterator>(keys_first, keys_last, out);
+		}
+
+		template<typename In, typename Out>
+		__device__
+		Out find_batch(In keys_first, In keys_last, Out out) const
+		{
+			return find_batch_as<const_iterator>(keys_first, keys_last, out);
+		}
+
 		__device__
 		bool empty() const
 		{
-			return impl.begin == impl.end;
+			return impl.root == impl.end;
+		}
+
+		/**
+		*	Calls @f on every value in ascending order. 
+		*	@f - function object taking a value const reference.
+		*	Returns @f.
+		*	NOTE: Walks the tree with an explicit stack, which touches every node once and never reads parent links, 
+		*	making it faster than stepping an iterator across the whole tree.
+		*/
+		template<typename F>
+		__device__
+		F for_each_inorder(F f) const
+		{
+			for_each_node_inorder([&](node const* x) { f(x->val); });
+			return f;
 		}
 
 		__device__
-		iterator begin() const
+		iterator begin()
 		{
-			return iterator{ impl.begin };
+			return iterator{ impl.begin, &impl };
 		}
 
 		__device__
-		iterator end() const
+		const_iterator begin() const
 		{
-			return iterator{ impl.end };
+			return const_iterator{ impl.begin, &impl };
+		}
+
+		__device__
+		const_iterator cbegin() const
+		{
+			return const_iterator{ impl.begin, &impl };
+		}
+
+		__device__
+		iterator end()
+		{
+			return iterator{ impl.end, &impl };
+		}
+
+		__device__
+		const_iterator end() const
+		{
+			return const_iterator{ impl.end, &impl };
+		}
+
+		__device__
+		const_iterator cend() const
+		{
+			return const_iterator{ impl.end, &impl };
+		}
+
+		__device__
+		reverse_iterator rbegin()
+		{
+			return reverse_iterator{ end() };
+		}
+
+		__device__
+		const_reverse_iterator rbegin() const
+		{
+			return const_reverse_iterator{ end() };
+		}
+
+		__device__
+		reverse_iterator rend()
+		{
+			return reverse_iterator{ begin() };
+		}
+
+		__device__
+		const_reverse_iterator rend() const
+		{
+			return const_reverse_iterator{ begin() };
+		}
+
+		/**
+		*	Returns the in-order successor of @x, or the sentinel if @x is the rightmost node.
+		*	@x - node to step from, must not be the sentinel.
+		*	@tree - tree implementation @x belongs to.
+		*/
+		__device__
+		static node* next(node* x, rb_tree_impl const* tree)
+		{
+			if (x->right != tree->end)
+			{
+				x = x->right;
+				while (x->left != tree->end)
+				{
+					x = x->left;
+				}
+				return x;
+			}
+			node* p = x->parent;
+			while (p != tree->end && x == p->right)
+			{
+				x = p;
+				p = p->parent;
+			}
+			return p;
+		}
+
+		/**
+		*	Returns the in-order predecessor of @x, stepping from the sentinel yields the rightmost node.
+		*	@x - node to step from, must not be the leftmost node.
+		*	@tree - tree implementation @x belongs to.
+		*/
+		__device__
+		static node* prev(node* x, rb_tree_impl const* tree)
+		{
+			if (x == tree->end)
+			{
+				return tree->rbegin;
+			}
+			if (x->left != tree->end)
+			{
+				x = x->left;
+				while (x->right != tree->end)
+				{
+					x = x->right;
+				}
+				return x;
+			}
+			node* p = x->parent;
+			while (p != tree->end && x == p->left)
+			{
+				x = p;
+				p = p->parent;
+			}
+			return p;
 		}
 
 		__device__
@@ -394,78 +897,503 @@ namespace cudlb
 		}
 
 	private:
+		/**
+		*	Upper limit on the height of a red-black tree with at most 2^64 nodes.
+		*/
+		static constexpr size_type max_height = 2 * 8 * sizeof(size_type);
+
+		/**
+		*	Returns the leftmost node of the subtree rooted at @x, or the sentinel if the subtree is empty.
+		*/
+		__device__
+		node* minimum(node* x) const
+		{
+			if (x == impl.end) return x;
+			while (x->left != impl.end)
+			{
+				x = x->left;
+			}
+			return x;
+		}
+
+		/**
+		*	Returns the rightmost node of the subtree rooted at @x, or the sentinel if the subtree is empty.
+		*/
+		__device__
+		node* maximum(node* x) const
+		{
+			if (x == impl.end) return x;
+			while (x->right != impl.end)
+			{
+				x = x->right;
+			}
+			return x;
+		}
+
+		/**
+		*	Returns the node of the k-th smallest value, or the sentinel if @k is not less than size().
+		*/
+		__device__
+		node* select_node(size_type k) const
+		{
+			static_assert(node::augment::enabled, "rb_tree::select() requires the rb_tree_order_statistic policy");
+			node* x = impl.root;
+			while (x != impl.end)
+			{
+				size_type const left_size = x->left->size;
+				if (k < left_size)
+				{
+					x = x->left;
+				}
+				else if (k == left_size)
+				{
+					break;
+				}
+				else
+				{
+					k -= left_size + 1;
+					x = x->right;
+				}
+			}
+			return x;
+		}
+
+		/**
+		*	Returns the node of the first value which is NOT LESS than @key, or the sentinel if there is none.
+		*/
+		__device__
+		node* lower_bound_node(value const& key) const
+		{
+			node* y = impl.end;
+			node* x = impl.root;
+			while (x != impl.end)
+			{
+				if (!impl.comp(x->val, key))
+				{
+					y = x;
+					x = x->left;
+				}
+				else
+				{
+					x = x->right;
+				}
+			}
+			return y;
+		}
+
+		/**
+		*	Returns the node of the first value which is GREATER than @key, or the sentinel if there is none.
+		*/
+		__device__
+		node* upper_bound_node(value const& key) const
+		{
+			node* y = impl.end;
+			node* x = impl.root;
+			while (x != impl.end)
+			{
+				if (impl.comp(key, x->val))
+				{
+					y = x;
+					x = x->left;
+				}
+				else
+				{
+					x = x->right;
+				}
+			}
+			return y;
+		}
+
+		/**
+		*	Returns the node of the first value equal to @key, or the sentinel if there is none.
+		*/
+		__device__
+		node* find_node(value const& key) const
+		{
+			node* const y = lower_bound_node(key);
+			return y != impl.end && !impl.comp(key, y->val) ? y : impl.end;
+		}
+
+		/**
+		*	Body of find_batch, writing the results as Iterator, the iterator or const_iterator of the tree.
+		*/
+		template<typename Iterator, typename In, typename Out>
+		__device__
+		Out find_batch_as(In keys_first, In keys_last, Out out) const
+		{
+			// Each path entry records a node and the nearest ancestor where the descent went left, which bounds 
+			// the node's subtree from above. Lower bounds never need checking as the keys are ascending.
+			node* path[max_height];
+			node* bound[max_height];
+			size_type depth = 0;
+
+			for (; keys_first != keys_last; ++keys_first, ++out)
+			{
+				value const& key = *keys_first;
+				node* x = impl.root;
+				node* y = impl.end;
+				if (depth != 0)
+				{
+					while (depth > 1 && bound[depth - 1] != impl.end && impl.comp(bound[depth - 1]->val, key))
+					{
+						--depth;
+					}
+					--depth;
+					x = path[depth];
+					y = bound[depth];
+				}
+
+				while (x != impl.end)
+				{
+					path[depth] = x;
+					bound[depth] = y;
+					++depth;
+					if (!impl.comp(x->val, key))
+					{
+						y = x;
+						x = x->left;
+					}
+					else
+					{
+						x = x->right;
+					}
+				}
+
+				if (y != impl.end && !impl.comp(key, y->val))
+					*out = Iterator{ y, &impl };
+				else
+					*out = Iterator{ impl.end, &impl };
+			}
+			return out;
+		}
+
+		/**
+		*	Destroys all nodes in post-order, detaching each leaf from its parent before it is released.
+		*/
 		__device__ 
 		void delete_tree()
 		{
-			if (!empty())
+			node* x = impl.root;
+			while (x != impl.end)
+			{
+				if (x->left != impl.end)
+				{
+					x = x->left;
+				}
+				else if (x->right != impl.end)
+				{
+					x = x->right;
+				}
+				else
+				{
+					node* p = x->parent;
+					if (p != impl.end)
+					{
+						if (p->left == x) p->left = impl.end;
+						else p->right = impl.end;
+					}
+					release(x);
+					x = p;
+				}
+			}
+			impl.root = impl.begin = impl.rbegin = impl.end;
+			impl.alloc.deallocate(impl.pool, impl.pool_size);
+			impl.pool = nullptr;
+			impl.pool_size = 0;
+		}
+
+		/**
+		*	Destroys a node which is no longer linked into the tree and returns its space to the allocator,
+		*	unless it lives in the block allocated by compact(), which is only returned as a whole.
+		*/
+		__device__
+		void release(node* x)
+		{
+			impl.alloc.destroy(x);
+			if (impl.pool == nullptr || x < impl.pool || impl.pool + impl.pool_size <= x)
+			{
+				impl.alloc.deallocate(x);
+			}
+		}
+
+		/**
+		*	Calls @f on every node in ascending order, walking the tree with an explicit stack.
+		*/
+		template<typename F>
+		__device__
+		void for_each_node_inorder(F f) const
+		{
+			node* stack[max_height];
+			size_type top = 0;
+			node* x = impl.root;
+			while (true)
 			{
-				node* x = impl.begin;
 				while (x != impl.end)
 				{
-					impl.alloc.destroy(x);
-					impl.alloc.deallocate(x);
-					++x;
+					stack[top++] = x;
+					x = x->left;
 				}
-				impl.root = impl.begin = impl.end = nullptr;
+				if (top == 0) break;
+				x = stack[--top];
+				f(x);
+				x = x->right;
+			}
+		}
+
+		/**
+		*	Returns the number of nodes in the tree.
+		*/
+		__device__
+		size_type count_nodes() const
+		{
+			size_type n = 0;
+			for_each_node_inorder([&](node*) { ++n; });
+			return n;
+		}
+
+		/**
+		*	Returns the number of levels of the tree, 0 for an empty tree.
+		*/
+		__device__
+		size_type height() const
+		{
+			node* stack[max_height];
+			size_type depth[max_height];
+			size_type top = 0;
+			size_type h = 0;
+			if (impl.root != impl.end)
+			{
+				stack[top] = impl.root;
+				depth[top++] = 1;
+			}
+			while (top != 0)
+			{
+				--top;
+				node* x = stack[top];
+				size_type const d = depth[top];
+				if (h < d) h = d;
+				if (x->left != impl.end)
+				{
+					stack[top] = x->left;
+					depth[top++] = d + 1;
+				}
+				if (x->right != impl.end)
+				{
+					stack[top] = x->right;
+					depth[top++] = d + 1;
+				}
+			}
+			return h;
+		}
+
+		/**
+		*	Appends the nodes of the subtree rooted at @x, cut @h levels deep, to @order in van Emde Boas order:
+		*	the top h / 2 levels first, then each subtree hanging below them from left to right, all laid out recursively.
+		*	@x - root of the subtree.
+		*	@h - number of levels to lay out.
+		*	@order - output array of nodes.
+		*	@pos - next free position in @order.
+		*/
+		__device__
+		void veb_order(node* x, size_type h, node** order, size_type& pos) const
+		{
+			if (x == impl.end) return;
+			if (h == 1)
+			{
+				order[pos++] = x;
+				return;
 			}
+			size_type const top = h / 2;
+			veb_order(x, top, order, pos);
+			veb_bottom(x, top, h - top, order, pos);
+		}
+
+		/**
+		*	Lays out, from left to right, every subtree rooted @depth levels below @x, each cut @h levels deep.
+		*/
+		__device__
+		void veb_bottom(node* x, size_type depth, size_type h, node** order, size_type& pos) const
+		{
+			if (x == impl.end) return;
+			if (depth == 0)
+			{
+				veb_order(x, h, order, pos);
+				return;
+			}
+			veb_bottom(x->left, depth - 1, h, order, pos);
+			veb_bottom(x->right, depth - 1, h, order, pos);
 		}
 
 		rb_tree_impl impl;
 	};
 
-	template<typename T, typename Comp, typename Allocator> 
-	struct rb_tree<T, Comp, Allocator>::iterator {
-		using node = rb_tree_node<T>;
+	template<typename T, typename Comp, typename Allocator, typename Augment> 
+	struct rb_tree<T, Comp, Allocator, Augment>::iterator {
+		using node = rb_tree_node<T, Augment>;
+		using value = T;
+		using iterator_category = cudlb::bidirectional_iterator_tag;
+		using value_type = T;
+		using reference = T&;
+		using pointer = T*;
+		using difference_type = ptrdiff_t;
+		using tree = rb_tree<T, Comp, Allocator, Augment>;
+		using tree_impl = typename tree::rb_tree_impl;
 
 		__device__
 		explicit iterator(cudlb::nullptr_t)
-			: nd{ nullptr }
+			: nd{ nullptr }, impl{ nullptr }
 		{}
 
 		__device__
-		explicit iterator(node* nd)
-			: nd{ nd }
+		iterator(node* nd, tree_impl const* impl)
+			: nd{ nd }, impl{ impl }
 		{}
 
+		__device__
+		reference operator*() const
+		{
+			return nd->val;
+		}
+
+		__device__
+		value* operator->() const
+		{
+			return &nd->val;
+		}
+
 		__device__
 		iterator& operator++()
 		{
-			if (nd->right)
-			{
-				nd = nd->right; 
-				while (nd->left)
-				{
-					nd = nd->left; 
-				}
-			}
-			else
-			{
-				node* p = nd->parent; 
-				while (p && nd == p->right)
-				{
-					nd = p; 
-					p = p->parent;
-				}
-				nd = p;
-			}
+			nd = tree::next(nd, impl);
 			return *this;
 		}
 
+		__device__
+		iterator operator++(int)
+		{
+			iterator temp = *this;
+			nd = tree::next(nd, impl);
+			return temp;
+		}
+
 		__device__
 		iterator& operator--()
 		{
-			// TODO
+			nd = tree::prev(nd, impl);
 			return *this;
 		}
 
+		__device__
+		iterator operator--(int)
+		{
+			iterator temp = *this;
+			nd = tree::prev(nd, impl);
+			return temp;
+		}
+
+		__device__
+		bool operator==(iterator const& other) const
+		{
+			return nd == other.nd;
+		}
+
+		__device__
+		bool operator!=(iterator const& other) const
+		{
+			return nd != other.nd;
+		}
+
 		node* nd;
+		tree_impl const* impl;
 	};
 
-	template<typename T, typename Comp, typename Allocator>
-	struct rb_tree<T, Comp, Allocator>::const_iterator {
+	template<typename T, typename Comp, typename Allocator, typename Augment>
+	struct rb_tree<T, Comp, Allocator, Augment>::const_iterator {
+		using node = rb_tree_node<T, Augment>;
+		using value = T;
+		using iterator_category = cudlb::bidirectional_iterator_tag;
+		using value_type = T;
+		using reference = T const&;
+		using pointer = T const*;
+		using difference_type = ptrdiff_t;
+		using tree = rb_tree<T, Comp, Allocator, Augment>;
+		using tree_impl = typename tree::rb_tree_impl;
+
+		__device__
+		explicit const_iterator(cudlb::nullptr_t)
+			: nd{ nullptr }, impl{ nullptr }
+		{}
+
+		__device__
+		const_iterator(node* nd, tree_impl const* impl)
+			: nd{ nd }, impl{ impl }
+		{}
+
+		/**
+		*	Converts a mutable iterator into a constant one.
+		*/
+		__device__
+		const_iterator(iterator const& other)
+			: nd{ other.nd }, impl{ other.impl }
+		{}
+
+		__device__
+		reference operator*() const
+		{
+			return nd->val;
+		}
+
+		__device__
+		value const* operator->() const
+		{
+			return &nd->val;
+		}
 
+		__device__
+		const_iterator& operator++()
+		{
+			nd = tree::next(nd, impl);
+			return *this;
+		}
+
+		__device__
+		const_iterator operator++(int)
+		{
+			const_iterator temp = *this;
+			nd = tree::next(nd, impl);
+			return temp;
+		}
+
+		__device__
+		const_iterator& operator--()
+		{
+			nd = tree::prev(nd, impl);
+			return *this;
+		}
+
+		__device__
+		const_iterator operator--(int)
+		{
+			const_iterator temp = *this;
+			nd = tree::prev(nd, impl);
+			return temp;
+		}
+
+		__device__
+		bool operator==(const_iterator const& other) const
+		{
+			return nd == other.nd;
+		}
+
+		__device__
+		bool operator!=(const_iterator const& other) const
+		{
+			return nd != other.nd;
+		}
+
+		node* nd;
+		tree_impl const* impl;
 	};
 
 }
 
-
@@ -0,0 +1,284 @@
+#pragma once
+#include "device_type_traits.h"
+#include "device_execution.h"
+#include "device_algorithm.h"
+#include "device_numeric.h"
+
+namespace cudlb
+{
+	/**
+	*	Segmented algorithms work on many variable length lists stored back to back in one flat range of values,
+	*	described by a CSR-style offsets range of segments + 1 ascending entries: segment s is made of the values
+	*	[first + offsets[s] : first + offsets[s + 1]).
+	*/
+
+	/**
+	*	Returns the first segment which starts at or after element @position.
+	*/
+	template<typename OffsetIterator>
+	__host__ __device__
+	size_t segment_at(OffsetIterator offsets, size_t const segments, size_t const position)
+	{
+		using offset_type = typename cudlb::remove_cv<typename cudlb::remove_reference<decltype(*offsets)>::value_type>::value_type;
+		return static_cast<size_t>(cudlb::lower_bound(offsets, offsets + segments, static_cast<offset_type>(position)) - offsets);
+	}
+
+	/**
+	*	Calls the algorithm of a segmented operation on every segment, grouped by size class.
+	*	The values are split into tiles of equal numbers of elements, not of segments, and every tile processes the
+	*	segments which start inside it with @small, so that a tile of many tiny segments and a tile of a few longer
+	*	ones carry the same load. Segments longer than a tile would unbalance the tiles, they are processed
+	*	afterwards one at a time with @large, which runs a parallel algorithm on the whole segment.
+	*	@offsets - start of the offsets range.
+	*	@segments - number of segments.
+	*	@parallel - false to process all segments with @small on the calling thread.
+	*/
+	template<typename OffsetIterator, typename Small, typename Large>
+	__host__ __device__
+	void tiled_segments(OffsetIterator offsets, size_t const segments, bool const parallel, Small const& small, Large const& large)
+	{
+		if (segments == 0) return;
+		size_t const base = static_cast<size_t>(offsets[0]);
+		size_t const total = static_cast<size_t>(offsets[segments]) - base;
+		cudlb::tiling const tiles = parallel ? cudlb::make_tiling(total) : cudlb::tiling{ total, 1 };
+		size_t const large_size = tiles.tiles == 1 ? ~static_cast<size_t>(0) : total / tiles.tiles;
+
+		cudlb::parallel_for(tiles.tiles, [&](size_t const t) {
+			size_t s = t == 0 ? 0 : cudlb::segment_at(offsets, segments, base + tiles.begin(t));
+			size_t const end = t + 1 == tiles.tiles ? segments : cudlb::segment_at(offsets, segments, base + tiles.end(t));
+			for (; s < end; ++s)
+			{
+				if (static_cast<size_t>(offsets[s + 1] - offsets[s]) < large_size) small(s);
+			}
+		});
+		if (tiles.tiles == 1) return;
+		for (size_t s = 0; s != segments; ++s)
+		{
+			if (static_cast<size_t>(offsets[s + 1] - offsets[s]) >= large_size) large(s);
+		}
+	}
+
+	/**
+	*	Sorts one segment of a segmented sort on the calling thread, by size class:
+	*	up to 32 elements with cudlb::network_sort, longer segments with cudlb::stable_sort.
+	*/
+	template<typename Iterator, typename Compare>
+	__host__ __device__
+	void sort_segment(Iterator first, Iterator last, Compare comp)
+	{
+		size_t const n = static_cast<size_t>(last - first);
+		if (n <= 32) cudlb::network_sort(first, n, comp);
+		else cudlb::stable_sort(first, last, comp);
+	}
+
+	/**
+	*	Sorts every segment of a flat range of values independently.
+	*	@first - start of the random access range of values.
+	*	@[offsets_first : offsets_last) - offsets of the segments, one more than the number of segments.
+	*	@comp - comparator, true if the first argument is ordered before the second.
+	*	NOTE: Segments of up to 32 elements are sorted by a sorting network, which does not keep the order
+	*	of equivalent elements.
+	*	NOTE: The overloads taking a comparator or an operation are removed when the first argument is a policy,
+	*	otherwise segmented_sort(cudlb::par, first, offsets_first, offsets_last) would match both.
+	*/
+	template<typename Iterator, typename OffsetIterator, typename Compare>
+	__host__ __device__
+	typename cudlb::enable_if<!cudlb::is_execution_policy<Iterator>::value>::type
+		segmented_sort(Iterator first, OffsetIterator offsets_first, OffsetIterator offsets_last, Compare comp)
+	{
+		size_t const segments = static_cast<size_t>(offsets_last - offsets_first) - 1;
+		auto const segment = [&](size_t const s) {
+			cudlb::sort_segment(first + offsets_first[s], first + offsets_first[s + 1], comp);
+		};
+		cudlb::tiled_segments(offsets_first, segments, false, segment, segment);
+	}
+
+	template<typename Iterator, typename OffsetIterator>
+	__host__ __device__
+	void segmented_sort(Iterator first, OffsetIterator offsets_first, OffsetIterator offsets_last)
+	{
+		using value_type = typename cudlb::remove_cv<typename cudlb::remove_reference<decltype(*first)>::value_type>::value_type;
+		cudlb::segmented_sort(first, offsets_first, offsets_last, cudlb::less<value_type>());
+	}
+
+	/**
+	*	Parallel cudlb::segmented_sort, segments longer than a tile are sorted by the parallel cudlb::stable_sort.
+	*/
+	template<typename Iterator, typename OffsetIterator, typename Compare>
+	__host__ __device__
+	void segmented_sort(cudlb::parallel_policy policy, Iterator first, OffsetIterator offsets_first, OffsetIterator offsets_last, Compare comp)
+	{
+		size_t const segments = static_cast<size_t>(offsets_last - offsets_first) - 1;
+		cudlb::tiled_segments(offsets_first, segments, true,
+			[&](size_t const s) { cudlb::sort_segment(first + offsets_first[s], first + offsets_first[s + 1], comp); },
+			[&](size_t const s) { cudlb::stable_sort(policy, first + offsets_first[s], first + offsets_first[s + 1], comp); });
+	}
+
+	template<typename Iterator, typename OffsetIterator>
+	__host__ __device__
+	void segmented_sort(cudlb::parallel_policy policy, Iterator first, OffsetIterator offsets_first, OffsetIterator offsets_last)
+	{
+		using value_type = typename cudlb::remove_cv<typename cudlb::remove_reference<decltype(*first)>::value_type>::value_type;
+		cudlb::segmented_sort(policy, first, offsets_first, offsets_last, cudlb::less<value_type>());
+	}
+
+	/**
+	*	Reduces every segment of a flat range of values independently.
+	*	@first - start of the random access range of values.
+	*	@[offsets_first : offsets_last) - offsets of the segments, one more than the number of segments.
+	*	@out - start of the output range, receives one result per segment.
+	*	@init - initial value of the result of every segment, the result of empty segments.
+	*	@op - associative binary operation.
+	*	Returns an iterator past the last result written.
+	*/
+	template<typename Iterator, typename OffsetIterator, typename OutputIterator, typename T, typename BinaryOp>
+	__host__ __device__
+	typename cudlb::enable_if<!cudlb::is_execution_policy<Iterator>::value, OutputIterator>::type
+		segmented_reduce(Iterator first, OffsetIterator offsets_first, OffsetIterator offsets_last, OutputIterator out, T init, BinaryOp op)
+	{
+		size_t const segments = static_cast<size_t>(offsets_last - offsets_first) - 1;
+		auto const segment = [&](size_t const s) {
+			out[s] = cudlb::reduce(first + offsets_first[s], first + offsets_first[s + 1], init, op);
+		};
+		cudlb::tiled_segments(offsets_first, segments, false, segment, segment);
+		return out + segments;
+	}
+
+	template<typename Iterator, typename OffsetIterator, typename OutputIterator, typename T>
+	__host__ __device__
+	OutputIterator segmented_reduce(Iterator first, OffsetIterator offsets_first, OffsetIterator offsets_last, OutputIterator out, T init)
+	{
+		return cudlb::segmented_reduce(first, offsets_first, offsets_last, out, init, cudlb::plus<T>());
+	}
+
+	/**
+	*	Parallel cudlb::segmented_reduce, segments longer than a tile are reduced by the parallel cudlb::reduce.
+	*/
+	template<typename Iterator, typename OffsetIterator, typename OutputIterator, typename T, typename BinaryOp>
+	__host__ __device__
+	OutputIterator segmented_reduce(cudlb::parallel_policy policy, Iterator first, OffsetIterator offsets_first, OffsetIterator offsets_last, OutputIterator out, T init, BinaryOp op)
+	{
+		size_t const segments = static_cast<size_t>(offsets_last - offsets_first) - 1;
+		cudlb::tiled_segments(offsets_first, segments, true,
+			[&](size_t const s) { out[s] = cudlb::reduce(first + offsets_first[s], first + offsets_first[s + 1], init, op); },
+			[&](size_t const s) { out[s] = cudlb::reduce(policy, first + offsets_first[s], first + offsets_first[s + 1], init, op); });
+		return out + segments;
+	}
+
+	template<typename Iterator, typename OffsetIterator, typename OutputIterator, typename T>
+	__host__ __device__
+	OutputIterator segmented_reduce(cudlb::parallel_policy policy, Iterator first, OffsetIterator offsets_first, OffsetIterator offsets_last, OutputIterator out, T init)
+	{
+		return cudlb::segmented_reduce(policy, first, offsets_first, offsets_last, out, init, cudlb::plus<T>());
+	}
+
+	/**
+	*	Computes the inclusive scan of every segment of a flat range of values independently,
+	*	the output of a segment starts at the same offset as its values.
+	*	@first - start of the random access range of values.
+	*	@[offsets_first : offsets_last) - offsets of the segments, one more than the number of segments.
+	*	@out - start of the random access output range, may be equal to @first.
+	*	@op - associative binary operation.
+	*/
+	template<typename Iterator, typename OffsetIterator, typename OutputIterator, typename BinaryOp>
+	__host__ __device__
+	typename cudlb::enable_if<!cudlb::is_execution_policy<Iterator>::value>::type
+		segmented_inclusive_scan(Iterator first, OffsetIterator offsets_first, OffsetIterator offsets_last, OutputIterator out, BinaryOp op)
+	{
+		size_t const segments = static_cast<size_t>(offsets_last - offsets_first) - 1;
+		auto const segment = [&](size_t const s) {
+			cudlb::inclusive_scan(first + offsets_first[s], first + offsets_first[s + 1], out + offsets_first[s], op);
+		};
+		cudlb::tiled_segments(offsets_first, segments, false, segment, segment);
+	}
+
+	template<typename Iterator, typename OffsetIterator, typename OutputIterator>
+	__host__ __device__
+	void segmented_inclusive_scan(Iterator first, OffsetIterator offsets_first, OffsetIterator offsets_last, OutputIterator out)
+	{
+		using value_type = typename cudlb::remove_cv<typename cudlb::remove_reference<decltype(*first)>::value_type>::value_type;
+		cudlb::segmented_inclusive_scan(first, offsets_first, offsets_last, out, cudlb::plus<value_type>());
+	}
+
+	/**
+	*	Parallel cudlb::segmented_inclusive_scan, segments longer than a tile are scanned by the parallel cudlb::inclusive_scan.
+	*/
+	template<typename Iterator, typename OffsetIterator, typename OutputIterator, typename BinaryOp>
+	__host__ __device__
+	void segmented_inclusive_scan(cudlb::parallel_policy policy, Iterator first, OffsetIterator offsets_first, OffsetIterator offsets_last, OutputIterator out, BinaryOp op)
+	{
+		size_t const segments = static_cast<size_t>(offsets_last - offsets_first) - 1;
+		cudlb::tiled_segments(offsets_first, segments, true,
+			[&](size_t const s) { cudlb::inclusive_scan(first + offsets_first[s], first + offsets_first[s + 1], out + offsets_first[s], op); },
+			[&](size_t const s) { cudlb::inclusive_scan(policy, first + offsets_first[s], first + offsets_first[s + 1], out + offsets_first[s], op); });
+	}
+
+	template<typename Iterator, typename OffsetIterator, typename OutputIterator>
+	__host__ __device__
+	void segmented_inclusive_scan(cudlb::parallel_policy policy, Iterator first, OffsetIterator offsets_first, OffsetIterator offsets_last, OutputIterator out)
+	{
+		using value_type = typename cudlb::remove_cv<typename cudlb::remove_reference<decltype(*first)>::value_type>::value_type;
+		cudlb::segmented_inclusive_scan(policy, first, offsets_first, offsets_last, out, cudlb::plus<value_type>());
+	}
+
+	/**
+	*	Computes the exclusive scan of every segment of a flat range of values independently, each starting from @init,
+	*	the output of a segment starts at the same offset as its values.
+	*	@first - start of the random access range of values.
+	*	@[offsets_first : offsets_last) - offsets of the segments, one more than the number of segments.
+	*	@out - start of the random access output range, may be equal to @first.
+	*	@init - first output value of every segment.
+	*	@op - associative binary operation.
+	*/
+	template<typename Iterator, typename OffsetIterator, typename OutputIterator, typename T, typename BinaryOp>
+	__host__ __device__
+	typename cudlb::enable_if<!cudlb::is_execution_policy<Iterator>::value>::type
+		segmented_exclusive_scan(Iterator first, OffsetIterator offsets_first, OffsetIterator offsets_last, OutputIterator out, T init, BinaryOp op)
+	{
+		size_t const segments = static_cast<size_t>(offsets_last - offsets_first) - 1;
+		auto const segment = [&](size_t const s) {
+			cudlb::exclusive_scan(first + offsets_first[s], first + offsets_first[s + 1], out + offsets_first[s], init, op);
+		};
+		cudlb::tiled_segments(offsets_first, segments, false, segment, segment);
+	}
+
+	template<typename Iterator, typename OffsetIterator, typename OutputIterator, typename T>
+	__host__ __device__
+	void segmented_exclusive_scan(Iterator first, OffsetIterator offsets_first, OffsetIterator offsets_last, OutputIterator out, T init)
+	{
+		cudlb::segmented_exclusive_scan(first, offsets_first, offsets_last, out, init, cudlb::plus<T>());
+	}
+
+	/**
+	*	Parallel cudlb::segmented_exclusive_scan, segments longer than a tile are scanned by the parallel cudlb::exclusive_scan.
+	*/
+	template<typename Iterator, typename OffsetIterator, typename OutputIterator, typename T, typename BinaryOp>
+	__host__ __device__
+	void segmented_exclusive_scan(cudlb::parallel_policy policy, Iterator first, OffsetIterator offsets_first, OffsetIterator offsets_last, OutputIterator out, T init, BinaryOp op)
+	{
+		size_t const segments = static_cast<size_t>(offsets_last - offsets_first) - 1;
+		cudlb::tiled_segments(offsets_first, segments, true,
+			[&](size_t const s) { cudlb::exclusive_scan(first + offsets_first[s], first + offsets_first[s + 1], out + offsets_first[s], init, op); },
+			[&](size_t const s) { cudlb::exclusive_scan(policy, first + offsets_first[s], first + offsets_first[s + 1], out + offsets_first[s], init, op); });
+	}
+
+	template<typename Iterator, typename OffsetIterator, typename OutputIterator, typename T>
+	__host__ __device__
+	void segmented_exclusive_scan(cudlb::parallel_policy policy, Iterator first, OffsetIterator offsets_first, OffsetIterator offsets_last, OutputIterator out, T init)
+	{
+		cudlb::segmented_exclusive_scan(policy, first, offsets_first, offsets_last, out, init, cudlb::plus<T>());
+	}
+
+	/**
+	*	The par overloads without a comparator or an operation take as many arguments as the serial ones with one,
+	*	check at compile time that calls to them resolve.
+	*/
+	static_assert(cudlb::is_same<decltype(cudlb::segmented_sort(cudlb::par, static_cast<int*>(nullptr), static_cast<int*>(nullptr), static_cast<int*>(nullptr))), void>::value,
+		"cudlb::segmented_sort(par, first, offsets_first, offsets_last) does not resolve");
+	static_assert(cudlb::is_same<decltype(cudlb::segmented_reduce(cudlb::par, static_cast<int*>(nullptr), static_cast<int*>(nullptr), static_cast<int*>(nullptr), static_cast<int*>(nullptr), 0)), int*>::value,
+		"cudlb::segmented_reduce(par, first, offsets_first, offsets_last, out, init) does not resolve");
+	static_assert(cudlb::is_same<decltype(cudlb::segmented_inclusive_scan(cudlb::par, static_cast<int*>(nullptr), static_cast<int*>(nullptr), static_cast<int*>(nullptr), static_cast<int*>(nullptr))), void>::value,
+		"cudlb::segmented_inclusive_scan(par, first, offsets_first, offsets_last, out) does not resolve");
+	static_assert(cudlb::is_same<decltype(cudlb::segmented_exclusive_scan(cudlb::par, static_cast<int*>(nullptr), static_cast<int*>(nullptr), static_cast<int*>(nullptr), static_cast<int*>(nullptr), 0)), void>::value,
+		"cudlb::segmented_exclusive_scan(par, first, offsets_first, offsets_last, out, init) does not resolve");
+}
@@ -0,0 +1,194 @@
+#pragma once
+#include <cstdint>
+#include "device_config.h"
+#include "device_utility.h"
+#include "device_type_traits.h"
+#if defined(CUDLB_AVX2)
+#include <immintrin.h>
+#elif defined(CUDLB_SSE2)
+#include <emmintrin.h>
+#endif
+
+namespace cudlb
+{
+	/**
+	*	Classifies the element types which can be compared a block at a time.
+	*	1, 2, 4 and 8 for integral types of that size, -4 for float, -8 for double and 0 for any other type.
+	*	Integral elements are compared bitwise, floating point elements with the ordered equality of the IEEE standard,
+	*	so -0.0 matches 0.0 and NaN matches nothing, exactly like operator==.
+	*/
+	template<typename T>
+	struct simd_kind : cudlb::integral_constant<int,
+		cudlb::is_integral<T>::value && (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8) ? static_cast<int>(sizeof(T)) :
+		cudlb::is_same<typename cudlb::remove_cv<T>::value_type, float>::value ? -4 :
+		cudlb::is_same<typename cudlb::remove_cv<T>::value_type, double>::value ? -8 : 0> {};
+
+	/**
+	*	Returns the number of bytes compared at a time, the width of an AVX2 or SSE2 register on the host
+	*	and of a 128-bit vector load on the device.
+	*/
+	__host__ __device__
+	constexpr size_t simd_block_bytes()
+	{
+	#if defined(CUDLB_AVX2)
+		return 32;
+	#else
+		return 16;
+	#endif
+	}
+
+	/**
+	*	Returns a mask with one bit for every element of a block of type T, at bit sizeof(T) * i for element i.
+	*/
+	template<typename T>
+	__host__ __device__
+	constexpr unsigned long long simd_lane_mask()
+	{
+		return sizeof(T) == 1 ? ~0ULL : sizeof(T) == 2 ? 0x5555555555555555ULL : sizeof(T) == 4 ? 0x1111111111111111ULL : 0x0101010101010101ULL;
+	}
+
+#if defined(CUDLB_AVX2)
+	template<typename T>
+	inline unsigned long long match_block_simd(T const* p, T const value, cudlb::integral_constant<int, 1>)
+	{
+		__m256i const v = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(p));
+		return static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(cudlb::bit_cast<char>(value)))));
+	}
+
+	template<typename T>
+	inline unsigned long long match_block_simd(T const* p, T const value, cudlb::integral_constant<int, 2>)
+	{
+		__m256i const v = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(p));
+		return static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_cmpeq_epi16(v, _mm256_set1_epi16(cudlb::bit_cast<short>(value)))));
+	}
+
+	template<typename T>
+	inline unsigned long long match_block_simd(T const* p, T const value, cudlb::integral_constant<int, 4>)
+	{
+		__m256i const v = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(p));
+		return static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_cmpeq_epi32(v, _mm256_set1_epi32(cudlb::bit_cast<int>(value)))));
+	}
+
+	template<typename T>
+	inline unsigned long long match_block_simd(T const* p, T const value, cudlb::integral_constant<int, 8>)
+	{
+		__m256i const v = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(p));
+		return static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_cmpeq_epi64(v, _mm256_set1_epi64x(cudlb::bit_cast<long long>(value)))));
+	}
+
+	template<typename T>
+	inline unsigned long long match_block_simd(T const* p, T const value, cudlb::integral_constant<int, -4>)
+	{
+		__m256 const eq = _mm256_cmp_ps(_mm256_loadu_ps(reinterpret_cast<float const*>(p)), _mm256_set1_ps(value), _CMP_EQ_OQ);
+		return static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_castps_si256(eq)));
+	}
+
+	template<typename T>
+	inline unsigned long long match_block_simd(T const* p, T const value, cudlb::integral_constant<int, -8>)
+	{
+		__m256d const eq = _mm256_cmp_pd(_mm256_loadu_pd(reinterpret_cast<double const*>(p)), _mm256_set1_pd(value), _CMP_EQ_OQ);
+		return static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_castpd_si256(eq)));
+	}
+#elif defined(CUDLB_SSE2)
+	template<typename T>
+	inline unsigned long long match_block_simd(T const* p, T const value, cudlb::integral_constant<int, 1>)
+	{
+		__m128i const v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(p));
+		return static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8(cudlb::bit_cast<char>(value)))));
+	}
+
+	template<typename T>
+	inline unsigned long long match_block_simd(T const* p, T const value, cudlb::integral_constant<int, 2>)
+	{
+		__m128i const v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(p));
+		return static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi16(v, _mm_set1_epi16(cudlb::bit_cast<short>(value)))));
+	}
+
+	template<typename T>
+	inline unsigned long long match_block_simd(T const* p, T const value, cudlb::integral_constant<int, 4>)
+	{
+		__m128i const v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(p));
+		return static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi32(v, _mm_set1_epi32(cudlb::bit_cast<int>(value)))));
+	}
+
+	template<typename T>
+	inline unsigned long long match_block_simd(T const* p, T const value, cudlb::integral_constant<int, 8>)
+	{
+		// SSE2 has no 64-bit comparison, both 32-bit halves of an element have to match.
+		__m128i const v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(p));
+		__m128i const eq = _mm_cmpeq_epi32(v, _mm_set1_epi64x(cudlb::bit_cast<long long>(value)));
+		return static_cast<unsigned int>(_mm_movemask_epi8(_mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)))));
+	}
+
+	template<typename T>
+	inline unsigned long long match_block_simd(T const* p, T const value, cudlb::integral_constant<int, -4>)
+	{
+		__m128 const eq = _mm_cmpeq_ps(_mm_loadu_ps(reinterpret_cast<float const*>(p)), _mm_set1_ps(value));
+		return static_cast<unsigned int>(_mm_movemask_epi8(_mm_castps_si128(eq)));
+	}
+
+	template<typename T>
+	inline unsigned long long match_block_simd(T const* p, T const value, cudlb::integral_constant<int, -8>)
+	{
+		__m128d const eq = _mm_cmpeq_pd(_mm_loadu_pd(reinterpret_cast<double const*>(p)), _mm_set1_pd(value));
+		return static_cast<unsigned int>(_mm_movemask_epi8(_mm_castpd_si128(eq)));
+	}
+#endif
+
+	/**
+	*	Compares a block of simd_block_bytes() bytes of elements to a value.
+	*	@p - first element of the block, aligned to simd_block_bytes() in device code.
+	*	@value - value to compare the elements to.
+	*	Returns a mask in which bit sizeof(T) * i is set if element i is equal to @value, other bits may be set
+	*	alongside it, so the index of the first match is countr_zero(mask) / sizeof(T) and the number of matches
+	*	is popcount(mask & simd_lane_mask<T>()).
+	*	NOTE: Only defined for element types with a non-zero simd_kind.
+	*/
+	template<typename T>
+	__host__ __device__
+	inline unsigned long long match_block(T const* p, T const value)
+	{
+	#if !defined(__CUDA_ARCH__) && defined(CUDLB_SSE2)
+		return cudlb::match_block_simd(p, value, cudlb::simd_kind<T>());
+	#else
+		// One vector load brings in the whole block, the comparisons then run on registers.
+		constexpr size_t lanes = cudlb::simd_block_bytes() / sizeof(T);
+		struct alignas(16) block {
+			T v[lanes];
+		};
+		block const b = *reinterpret_cast<block const*>(p);
+		unsigned long long mask = 0;
+		for (size_t i = 0; i != lanes; ++i)
+			mask |= static_cast<unsigned long long>(b.v[i] == value) << (i * sizeof(T));
+		return mask;
+	#endif
+	}
+
+#if !defined(__CUDA_ARCH__) && defined(CUDLB_SSE2)
+	/**
+	*	Compares a block of simd_block_bytes() bytes of 32-bit integers to a value.
+	*	@p - first element of the block, no alignment is required.
+	*	@value - value to compare the elements to.
+	*	Returns a mask laid out like the one of match_block, with the bits of element i set if it is less than @value.
+	*	NOTE: Host only, device code compares the elements one by one.
+	*/
+	template<typename T>
+	inline unsigned long long less_block(T const* p, T const value)
+	{
+		static_assert(cudlb::simd_kind<T>::value == 4, "cudlb::less_block requires 32-bit integers");
+		// Only signed comparisons exist, unsigned elements are compared with their sign bits flipped.
+		int const flip = static_cast<T>(-1) < static_cast<T>(0) ? 0 : -2147483647 - 1;
+	#if defined(CUDLB_AVX2)
+		__m256i const f = _mm256_set1_epi32(flip);
+		__m256i const v = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<__m256i const*>(p)), f);
+		__m256i const x = _mm256_xor_si256(_mm256_set1_epi32(cudlb::bit_cast<int>(value)), f);
+		return static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_cmpgt_epi32(x, v)));
+	#else
+		__m128i const f = _mm_set1_epi32(flip);
+		__m128i const v = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<__m128i const*>(p)), f);
+		__m128i const x = _mm_xor_si128(_mm_set1_epi32(cudlb::bit_cast<int>(value)), f);
+		return static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpgt_epi32(x, v)));
+	#endif
+	}
+#endif
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include "device_static_set.h"
+
+namespace cudlb
+{
+	/**
+	*	Immutable ordered map, built once from sorted keys and their values and optimised for lookups.
+	*	The keys are searched through a device_static_set, the values stay in sorted order and are indexed by the key's rank.
+	*/
+	template<typename K, typename V, typename Comp = cudlb::less<K>>
+	class device_static_map {
+	public:
+		using key_type = K;
+		using mapped_type = V;
+		using const_iterator = V const*;
+		using size_type = size_t;
+
+		/**
+		*	Builds the map from sorted keys and the values that belong to them.
+		*	@sorted_keys - keys sorted in ascending order according to @c.
+		*	@values - values, the value at position i belongs to the key at position i.
+		*	@c - comparison object used to order the keys.
+		*	NOTE: @sorted_keys and @values must have the same size.
+		*/
+		__device__
+		device_static_map(cudlb::device_vector<K> const& sorted_keys, cudlb::device_vector<V> const& values, Comp const& c = Comp())
+			: keys( sorted_keys, c ), vals( values )
+		{
+		}
+
+		/**
+		*	Returns the number of key-value pairs in the map.
+		*/
+		__device__
+		size_type size() const
+		{
+			return keys.size();
+		}
+
+		/**
+		*	Checks if the map holds no key-value pairs.
+		*/
+		__device__
+		bool empty() const
+		{
+			return keys.empty();
+		}
+
+		/**
+		*	Returns a constant iterator to the value of the smallest key.
+		*/
+		__device__
+		const_iterator begin() const
+		{
+			return vals.begin();
+		}
+
+		/**
+		*	Returns a constant iterator to one past the value of the largest key.
+		*/
+		__device__
+		const_iterator end() const
+		{
+			return vals.end();
+		}
+
+		/**
+		*	Returns the number of keys which are LESS than @key.
+		*	@key - key to look for.
+		*/
+		__device__
+		size_type rank(key_type const& key) const
+		{
+			return keys.rank(key);
+		}
+
+		/**
+		*	Looks for the value that belongs to a key equal to @key.
+		*	@key - key to look for.
+		*	Returns an iterator to the value if found, otherwise returns end().
+		*/
+		__device__
+		const_iterator find(key_type const& key) const
+		{
+			return vals.begin() + keys.find(key);
+		}
+
+		/**
+		*	Checks if the map holds a key equal to @key.
+		*	@key - key to look for.
+		*/
+		__device__
+		bool contains(key_type const& key) const
+		{
+			return keys.contains(key);
+		}
+
+	private:
+		cudlb::device_static_set<K, Comp> keys;
+		cudlb::device_vector<V> vals;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,150 @@
+#pragma once
+#include "device_vector.h"
+#include "device_bit.h"
+#include "device_utility.h"
+#include "device_type_traits.h"
+
+namespace cudlb
+{
+	/**
+	*	Immutable ordered set, built once from a sorted sequence and optimised for lookups.
+	*	Keys are stored in BFS (Eytzinger) order: the children of the key at position k are at 2k and 2k + 1,
+	*	so the first levels of every search share the same few cache lines and the next levels can be prefetched.
+	*	Lookups return the in-order rank of a key, which can be used to index any array sorted the same way.
+	*/
+	template<typename T, typename Comp = cudlb::less<T>, typename Allocator = cudlb::device_allocator<T>>
+	class device_static_set {
+	public:
+		using value_type = T;
+		using const_reference = T const&;
+		using size_type = size_t;
+
+		/**
+		*	Builds the set from a sorted sequence of keys.
+		*	@sorted - keys sorted in ascending order according to @c.
+		*	@c - comparison object used to order the keys.
+		*	NOTE: Duplicate keys are allowed, rank() returns the rank of the first of them.
+		*/
+		__device__
+		explicit device_static_set(cudlb::device_vector<T, Allocator> const& sorted, Comp const& c = Comp())
+			: comp{ c }, n{ sorted.size() }, keys( sorted.size() + 1 ), ranks( sorted.size() + 1 )
+		{
+			build(sorted);
+		}
+
+		/**
+		*	Returns the number of keys in the set.
+		*/
+		__device__
+		size_type size() const
+		{
+			return n;
+		}
+
+		/**
+		*	Checks if the set holds no keys.
+		*/
+		__device__
+		bool empty() const
+		{
+			return n == 0;
+		}
+
+		/**
+		*	Returns the number of keys which are LESS than @key, i.e. the in-order rank of the first key not less than @key.
+		*	Returns size() if all keys are less than @key.
+		*	@key - value to look for.
+		*/
+		__device__
+		size_type rank(value_type const& key) const
+		{
+			return ranks[descend(key)];
+		}
+
+		/**
+		*	Looks for a key equal to @key.
+		*	@key - value to look for.
+		*	Returns the in-order rank of the key if found, otherwise returns size().
+		*/
+		__device__
+		size_type find(value_type const& key) const
+		{
+			size_type const k = descend(key);
+			if (k != 0 && !comp(key, keys[k]))
+				return ranks[k];
+			return n;
+		}
+
+		/**
+		*	Checks if the set holds a key equal to @key.
+		*	@key - value to look for.
+		*/
+		__device__
+		bool contains(value_type const& key) const
+		{
+			return find(key) != n;
+		}
+
+	private:
+		/**
+		*	Number of keys that fit in one cache line, each search prefetches the descendants this far down.
+		*/
+		static constexpr size_type prefetch_stride = sizeof(T) < 64 ? 64 / sizeof(T) : 1;
+
+		/**
+		*	Walks the implicit tree in order and assigns the sorted keys to their BFS positions.
+		*	@sorted - keys sorted in ascending order.
+		*/
+		__device__
+		void build(cudlb::device_vector<T, Allocator> const& sorted)
+		{
+			// Position 0 is the "not found" slot the descent lands on when every key is less than the query.
+			ranks[0] = n;
+			if (n == 0) return;
+
+			size_type k = 1;
+			while (2 * k <= n) k = 2 * k;
+			for (size_type i = 0; i < n; ++i)
+			{
+				keys[k] = sorted[i];
+				ranks[k] = i;
+				if (2 * k + 1 <= n)
+				{
+					k = 2 * k + 1;
+					while (2 * k <= n) k = 2 * k;
+				}
+				else
+				{
+					k >>= cudlb::countr_one(k) + 1;
+				}
+			}
+		}
+
+		/**
+		*	Finds the BFS position of the first key not less than @key.
+		*	@key - value to look for.
+		*	Returns 0 if all keys are less than @key.
+		*	NOTE: The descent has no data dependent branches, the next position is computed from the comparison result.
+		*/
+		__device__
+		size_type descend(value_type const& key) const
+		{
+			value_type const* base = keys.data();
+			size_type k = 1;
+			while (k <= n)
+			{
+				// The descendants log2(prefetch_stride) levels below k are contiguous from k * prefetch_stride, fetch them while this level is compared.
+				size_type const ahead = k * prefetch_stride;
+				cudlb::prefetch(base + (ahead <= n ? ahead : n));
+				k = 2 * k + static_cast<size_type>(comp(base[k], key));
+			}
+			// Undo the trailing right turns, which leaves the last position where the search went left.
+			return k >> (cudlb::countr_one(k) + 1);
+		}
+
+		Comp comp;
+		size_type n;
+		cudlb::device_vector<T, Allocator> keys;		// Keys in BFS order, position 0 is unused.
+		cudlb::device_vector<size_type> ranks;			// In-order rank of the key at the same position.
+	};
+}
\ No newline at end of file
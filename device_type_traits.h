@@ -1,37 +1,45 @@
 #pragma once
+#include <cstddef>
+#include <iterator>
+#include "device_config.h"
 
 namespace cudlb
 {
 	/**
-	*	Temporary implementation of iterator traits, 
-	*	to be used for iterator only implementation of device_vector.
-	*	TODO Add complete list of traits
+	*	Wraps a compile time constant of type T, used as a tag to select overloads at compile time.
 	*/
-	template<typename T> 
-	struct iterator_traits {
-		using value_type = T; 
-		using pointer = T*;
-		using size_type = size_t; 
+	template<typename T, T v>
+	struct integral_constant {
+		static constexpr T value = v;
+		using value_type = T;
+		using type = integral_constant;
+	};
 
-		__device__
-		static size_type distance(T begin, T end)
-		{
-			return static_cast<size_type>(end - begin);
-		}
+	using true_type = cudlb::integral_constant<bool, true>;
+	using false_type = cudlb::integral_constant<bool, false>;
+
+	/**
+	*	Selects type T if the condition B is true, otherwise type F.
+	*/
+	template<bool B, typename T, typename F>
+	struct conditional {
+		using type = T;
 	};
 
-	// Pointer template specialization of iterator_traits class.
-	template<typename T> 
-	struct iterator_traits<T*> {
-		using value_type = T; 
-		using pointer = T*;
-		using size_type = size_t;
+	template<typename T, typename F>
+	struct conditional<false, T, F> {
+		using type = F;
+	};
 
-		__device__
-		static size_type distance(T begin, T end)
-		{
-			return static_cast<size_type>(end - begin);
-		}
+	/**
+	*	Has the member type T only if the condition B is true, removing a template from overload resolution otherwise.
+	*/
+	template<bool B, typename T = void>
+	struct enable_if {};
+
+	template<typename T>
+	struct enable_if<true, T> {
+		using type = T;
 	};
 
 	/**
@@ -60,19 +68,268 @@ namespace cudlb
 		using value_type = T; 
 	};
 
+	/**
+	*	Returns the type T without its top level const and volatile qualifiers.
+	*/
+	template<typename T>
+	struct remove_cv {
+		using value_type = T;
+	};
+
+	template<typename T>
+	struct remove_cv<T const> {
+		using value_type = T;
+	};
+
+	template<typename T>
+	struct remove_cv<T volatile> {
+		using value_type = T;
+	};
+
+	template<typename T>
+	struct remove_cv<T const volatile> {
+		using value_type = T;
+	};
+
+	/**
+	*	Iterator categories, each one a refinement of the previous one.
+	*	Input iterators are read in a single pass, forward iterators can be copied and read again,
+	*	bidirectional iterators also step back, random access iterators move by any distance in constant time
+	*	and contiguous iterators refer to elements stored next to each other in memory, like pointers.
+	*/
+	struct input_iterator_tag {};
+	struct forward_iterator_tag : cudlb::input_iterator_tag {};
+	struct bidirectional_iterator_tag : cudlb::forward_iterator_tag {};
+	struct random_access_iterator_tag : cudlb::bidirectional_iterator_tag {};
+	struct contiguous_iterator_tag : cudlb::random_access_iterator_tag {};
+
+	/**
+	*	Number of increments from begin to end, counted one step at a time.
+	*/
+	template<typename Iterator>
+	__host__ __device__
+	ptrdiff_t iterator_distance(Iterator begin, Iterator const& end, cudlb::input_iterator_tag)
+	{
+		ptrdiff_t n = 0;
+		for (; begin != end; ++begin)
+			++n;
+		return n;
+	}
+
+	template<typename Iterator>
+	__host__ __device__
+	ptrdiff_t iterator_distance(Iterator const& begin, Iterator const& end, cudlb::random_access_iterator_tag)
+	{
+		return static_cast<ptrdiff_t>(end - begin);
+	}
+
+	/**
+	*	Maps any list of types to void, to detect in a partial specialization that the types are well formed.
+	*/
+	template<typename... T>
+	struct void_type {
+		using type = void;
+	};
+
+	/**
+	*	Maps the iterator_category of an iterator to a cudlb tag, the tags of the standard library included,
+	*	so that iterators of standard containers passed to the host algorithms take the right implementation.
+	*/
+	template<typename Category>
+	struct iterator_category_tag {
+		using type = Category;
+	};
+
+	template<> struct iterator_category_tag<std::input_iterator_tag> { using type = cudlb::input_iterator_tag; };
+	template<> struct iterator_category_tag<std::forward_iterator_tag> { using type = cudlb::forward_iterator_tag; };
+	template<> struct iterator_category_tag<std::bidirectional_iterator_tag> { using type = cudlb::bidirectional_iterator_tag; };
+	template<> struct iterator_category_tag<std::random_access_iterator_tag> { using type = cudlb::random_access_iterator_tag; };
+
+	template<typename Iterator, typename = void>
+	struct iterator_traits_members {};
+
+	template<typename Iterator>
+	struct iterator_traits_members<Iterator, typename cudlb::void_type<typename Iterator::iterator_category>::type> {
+		using iterator_category = typename cudlb::iterator_category_tag<typename Iterator::iterator_category>::type;
+		using value_type = typename Iterator::value_type;
+		using difference_type = typename Iterator::difference_type;
+		using reference = typename Iterator::reference;
+		using pointer = typename Iterator::pointer;
+		using size_type = size_t;
+
+		/**
+		*	Returns the number of elements of [begin : end), in constant time for random access iterators.
+		*/
+		__host__ __device__
+		static size_type distance(Iterator begin, Iterator end)
+		{
+			return static_cast<size_type>(cudlb::iterator_distance(begin, end, iterator_category()));
+		}
+	};
+
+	/**
+	*	Properties of an iterator type, taken from its member types.
+	*	Every iterator of cudlb defines iterator_category, value_type, difference_type, reference and pointer,
+	*	the algorithms select their implementation by the iterator_category, see cudlb::is_iterator_category.
+	*	For a type without an iterator_category, such as an output only iterator, the traits are empty.
+	*/
+	template<typename Iterator>
+	struct iterator_traits : cudlb::iterator_traits_members<Iterator> {};
+
+	// Pointer template specialization of iterator_traits class, pointers are contiguous iterators.
+	template<typename T>
+	struct iterator_traits<T*> {
+		using iterator_category = cudlb::contiguous_iterator_tag;
+		using value_type = typename cudlb::remove_cv<T>::value_type;
+		using difference_type = ptrdiff_t;
+		using reference = T&;
+		using pointer = T*;
+		using size_type = size_t;
+
+		__host__ __device__
+		static size_type distance(T* begin, T* end)
+		{
+			return static_cast<size_type>(end - begin);
+		}
+	};
+
+	template<typename Category>
+	cudlb::true_type iterator_category_test(Category const*);
+
+	template<typename Category>
+	cudlb::false_type iterator_category_test(void const*);
+
+	/**
+	*	True if the category of an iterator is Category or a refinement of it,
+	*	for example is_iterator_category<T*, cudlb::random_access_iterator_tag> is true.
+	*	False for types which are not iterators of any category.
+	*/
+	template<typename Iterator, typename Category, typename = void>
+	struct is_iterator_category : cudlb::false_type {};
+
+	template<typename Iterator, typename Category>
+	struct is_iterator_category<Iterator, Category, typename cudlb::void_type<typename cudlb::iterator_traits<Iterator>::iterator_category>::type>
+		: decltype(cudlb::iterator_category_test<Category>(static_cast<typename cudlb::iterator_traits<Iterator>::iterator_category const*>(nullptr))) {};
+
+	/**
+	*	True if T and U name the same type, including qualifiers.
+	*/
+	template<typename T, typename U>
+	struct is_same : cudlb::false_type {};
+
+	template<typename T>
+	struct is_same<T, T> : cudlb::true_type {};
+
+	/**
+	*	True for the integral types, ignoring const and volatile qualifiers.
+	*/
+	template<typename T>
+	struct integral_type : cudlb::false_type {};
+
+	template<> struct integral_type<bool> : cudlb::true_type {};
+	template<> struct integral_type<char> : cudlb::true_type {};
+	template<> struct integral_type<signed char> : cudlb::true_type {};
+	template<> struct integral_type<unsigned char> : cudlb::true_type {};
+	template<> struct integral_type<wchar_t> : cudlb::true_type {};
+	template<> struct integral_type<char16_t> : cudlb::true_type {};
+	template<> struct integral_type<char32_t> : cudlb::true_type {};
+	template<> struct integral_type<short> : cudlb::true_type {};
+	template<> struct integral_type<unsigned short> : cudlb::true_type {};
+	template<> struct integral_type<int> : cudlb::true_type {};
+	template<> struct integral_type<unsigned int> : cudlb::true_type {};
+	template<> struct integral_type<long> : cudlb::true_type {};
+	template<> struct integral_type<unsigned long> : cudlb::true_type {};
+	template<> struct integral_type<long long> : cudlb::true_type {};
+	template<> struct integral_type<unsigned long long> : cudlb::true_type {};
+
+	template<typename T>
+	struct is_integral : cudlb::integral_type<typename cudlb::remove_cv<T>::value_type> {};
+
+	/**
+	*	True for the floating point types, ignoring const and volatile qualifiers.
+	*/
+	template<typename T>
+	struct floating_point_type : cudlb::false_type {};
+
+	template<> struct floating_point_type<float> : cudlb::true_type {};
+	template<> struct floating_point_type<double> : cudlb::true_type {};
+	template<> struct floating_point_type<long double> : cudlb::true_type {};
+
+	template<typename T>
+	struct is_floating_point : cudlb::floating_point_type<typename cudlb::remove_cv<T>::value_type> {};
+
+	/**
+	*	True if objects of type T can be copied as raw bytes, with memcpy, queried from the compiler.
+	*/
+	template<typename T>
+	struct is_trivially_copyable : cudlb::integral_constant<bool, __is_trivially_copyable(T)> {};
+
+	/**
+	*	True if two objects of type T compare equal exactly when their object representations are equal,
+	*	which allows ranges of T to be compared as raw bytes. Holds for integral and pointer types.
+	*	Specialize it as true for padding-free aggregates whose operator== compares all members bitwise.
+	*/
+	template<typename T>
+	struct has_unique_object_representation : cudlb::is_integral<T> {};
+
+	template<typename T>
+	struct has_unique_object_representation<T*> : cudlb::true_type {};
+
+	template<typename T>
+	struct has_unique_object_representation<T const> : cudlb::has_unique_object_representation<T> {};
+
 	/**
 	*	Function object for performing comparisons.
 	*	True if lhs < rhs.
 	*/
 	template<typename T>
 	struct less {
-		__device__
+		__host__ __device__
 		bool constexpr operator()(T const& lhs, T const& rhs) const
 		{
 			return lhs < rhs;
 		}
 	};
 
+	/**
+	*	Function object for performing addition.
+	*	Returns lhs + rhs.
+	*/
+	template<typename T>
+	struct plus {
+		__host__ __device__
+		T constexpr operator()(T const& lhs, T const& rhs) const
+		{
+			return lhs + rhs;
+		}
+	};
+
+	/**
+	*	Function object for performing multiplication.
+	*	Returns lhs * rhs.
+	*/
+	template<typename T>
+	struct multiplies {
+		__host__ __device__
+		T constexpr operator()(T const& lhs, T const& rhs) const
+		{
+			return lhs * rhs;
+		}
+	};
+
+	/**
+	*	Function object for performing equality comparisons.
+	*	True if lhs == rhs.
+	*/
+	template<typename T>
+	struct equal_to {
+		__host__ __device__
+		bool constexpr operator()(T const& lhs, T const& rhs) const
+		{
+			return lhs == rhs;
+		}
+	};
+
 	/**
 	*	Type of the null pointer literal nullptr.
 	*	Required for function and constructor declarations which can explicitly take nullptr as parameter.
@@ -0,0 +1,359 @@
+#pragma once
+#include "device_hash_table.h"
+
+namespace cudlb
+{
+	/**
+	*	Unordered associative container mapping unique keys to values.
+	*	Implemented as an open addressing hash table with linear probing, see hash_table,
+	*	keys and values are kept in separate arrays so that probes only touch keys.
+	*/
+	template<typename Key, typename T, typename Hash = cudlb::hash<Key>, typename KeyEqual = cudlb::equal_to<Key>, typename Allocator = cudlb::device_allocator<Key>>
+	class device_unordered_map : private hash_table<Key, T, Hash, KeyEqual, Allocator> {
+	public:
+		using key_type = Key;
+		using mapped_type = T;
+		using size_type = size_t;
+		using hasher = Hash;
+		using key_equal = KeyEqual;
+		using allocator = Allocator;
+		using table = hash_table<Key, T, Hash, KeyEqual, Allocator>;
+
+		struct iterator;
+		struct const_iterator;
+
+		/**
+		*	Default empty constructor, no space is allocated until the first insertion.
+		*/
+		__device__
+		device_unordered_map()
+			: table{ Hash(), KeyEqual(), Allocator() } {}
+
+		/**
+		*	Constructs an empty map with room for a user specified number of keys.
+		*	@n - number of keys that can be inserted without rehashing.
+		*	@h - hash function object.
+		*	@e - key equality function object.
+		*	@a - user specified allocator object.
+		*/
+		__device__
+		explicit device_unordered_map(size_type const n, Hash const& h = Hash(), KeyEqual const& e = KeyEqual(), Allocator const& a = Allocator())
+			: table{ h, e, a }
+		{
+			this->reserve(n);
+		}
+
+		/**
+		*	Inserts a key and its value, if the key is not in the map yet.
+		*	@key - key to insert.
+		*	@val - value of the key.
+		*	Returns an iterator to the element with the key and true if it was inserted, false if the key was already present.
+		*/
+		__device__
+		cudlb::pair<iterator, bool> insert(key_type const& key, mapped_type const& val)
+		{
+			auto result = this->insert_slot(key, val);
+			return cudlb::pair<iterator, bool>{ iterator{ this, result.first }, result.second };
+		}
+
+		/**
+		*	Inserts a key and constructs its value in place, if the key is not in the map yet.
+		*	@key - key to insert.
+		*	@arg - arguments forwarded to the value constructor.
+		*	Returns an iterator to the element with the key and true if it was inserted, false if the key was already present.
+		*/
+		template<typename... Arg>
+		__device__
+		cudlb::pair<iterator, bool> emplace(key_type const& key, Arg &&... arg)
+		{
+			auto result = this->insert_slot(key, cudlb::forward<Arg>(arg)...);
+			return cudlb::pair<iterator, bool>{ iterator{ this, result.first }, result.second };
+		}
+
+		/**
+		*	Returns a reference to the value of @key, inserting a default constructed value if the key is not present.
+		*	@key - key to look for.
+		*/
+		__device__
+		mapped_type& operator[](key_type const& key)
+		{
+			return this->values[this->insert_slot(key).first];
+		}
+
+		/**
+		*	Looks for an element with a key equal to @key.
+		*	@key - key to look for.
+		*	Returns an iterator to the element if found, otherwise returns end().
+		*/
+		__device__
+		iterator find(key_type const& key)
+		{
+			size_type const i = this->find_slot(key);
+			return iterator{ this, i == table::npos ? this->slots : i };
+		}
+
+		__device__
+		const_iterator find(key_type const& key) const
+		{
+			size_type const i = this->find_slot(key);
+			return const_iterator{ this, i == table::npos ? this->slots : i };
+		}
+
+		/**
+		*	Checks if the map holds an element with a key equal to @key.
+		*	@key - key to look for.
+		*/
+		__device__
+		bool contains(key_type const& key) const
+		{
+			return this->find_slot(key) != table::npos;
+		}
+
+		/**
+		*	Returns the number of elements with a key equal to @key, either 0 or 1.
+		*	@key - key to look for.
+		*/
+		__device__
+		size_type count(key_type const& key) const
+		{
+			return contains(key) ? 1 : 0;
+		}
+
+		/**
+		*	Removes the element with a key equal to @key, if there is one.
+		*	@key - key of the element to remove.
+		*	Returns the number of elements removed, either 0 or 1.
+		*/
+		__device__
+		size_type erase(key_type const& key)
+		{
+			size_type const i = this->find_slot(key);
+			if (i == table::npos) return 0;
+			this->erase_slot(i);
+			return 1;
+		}
+
+		/**
+		*	Removes the element an iterator points to.
+		*	@pos - iterator to the element to remove, must not be end().
+		*	NOTE: Elements that followed the erased one in its probe run move back, all iterators are invalidated.
+		*/
+		__device__
+		void erase(iterator pos)
+		{
+			this->erase_slot(pos.slot);
+		}
+
+		/**
+		*	Makes room for a user specified number of keys, so that inserting them never rehashes.
+		*	@n - number of keys to make room for.
+		*/
+		__device__
+		void reserve(size_type const n)
+		{
+			table::reserve(n);
+		}
+
+		/**
+		*	Removes all elements, the allocated space is kept.
+		*/
+		__device__
+		void clear()
+		{
+			table::clear();
+		}
+
+		/**
+		*	Returns the number of elements in the map.
+		*/
+		__device__
+		size_type size() const
+		{
+			return this->occupied;
+		}
+
+		/**
+		*	Checks if the map holds no elements.
+		*/
+		__device__
+		bool empty() const
+		{
+			return this->occupied == 0;
+		}
+
+		/**
+		*	Returns the number of slots in the table.
+		*/
+		__device__
+		size_type bucket_count() const
+		{
+			return this->slots;
+		}
+
+		/**
+		*	Returns the ratio of elements to slots.
+		*/
+		__device__
+		float load_factor() const
+		{
+			return this->slots == 0 ? 0.0f : static_cast<float>(this->occupied) / static_cast<float>(this->slots);
+		}
+
+		/**
+		*	Returns the load factor above which the table grows.
+		*/
+		__device__
+		float max_load_factor() const
+		{
+			return this->max_load;
+		}
+
+		/**
+		*	Sets the load factor above which the table grows.
+		*	@ml - new maximum load factor, clamped to the range [0.05 : 0.95].
+		*/
+		__device__
+		void max_load_factor(float const ml)
+		{
+			this->set_max_load_factor(ml);
+		}
+
+		__device__
+		iterator begin()
+		{
+			return iterator{ this, this->next_occupied(0) };
+		}
+
+		__device__
+		const_iterator begin() const
+		{
+			return const_iterator{ this, this->next_occupied(0) };
+		}
+
+		__device__
+		iterator end()
+		{
+			return iterator{ this, this->slots };
+		}
+
+		__device__
+		const_iterator end() const
+		{
+			return const_iterator{ this, this->slots };
+		}
+	};
+
+	/**
+	*	Forward iterator over the occupied slots of a device_unordered_map.
+	*	Dereferencing yields a pair of references to the key and the value.
+	*/
+	template<typename Key, typename T, typename Hash, typename KeyEqual, typename Allocator>
+	struct device_unordered_map<Key, T, Hash, KeyEqual, Allocator>::iterator {
+		using table = hash_table<Key, T, Hash, KeyEqual, Allocator>;
+		using iterator_category = cudlb::forward_iterator_tag;
+		using value_type = cudlb::pair<Key, T>;
+		using reference = cudlb::pair<Key const&, T&>;
+		using pointer = void;
+		using difference_type = ptrdiff_t;
+
+		__device__
+		iterator(table const* tbl, size_t slot)
+			: tbl{ tbl }, slot{ slot }
+		{}
+
+		__device__
+		reference operator*() const
+		{
+			return reference{ tbl->keys[slot], tbl->values[slot] };
+		}
+
+		__device__
+		iterator& operator++()
+		{
+			slot = tbl->next_occupied(slot + 1);
+			return *this;
+		}
+
+		__device__
+		iterator operator++(int)
+		{
+			iterator temp = *this;
+			slot = tbl->next_occupied(slot + 1);
+			return temp;
+		}
+
+		__device__
+		bool operator==(iterator const& other) const
+		{
+			return slot == other.slot;
+		}
+
+		__device__
+		bool operator!=(iterator const& other) const
+		{
+			return slot != other.slot;
+		}
+
+		table const* tbl;
+		size_t slot;
+	};
+
+	template<typename Key, typename T, typename Hash, typename KeyEqual, typename Allocator>
+	struct device_unordered_map<Key, T, Hash, KeyEqual, Allocator>::const_iterator {
+		using table = hash_table<Key, T, Hash, KeyEqual, Allocator>;
+		using iterator_category = cudlb::forward_iterator_tag;
+		using value_type = cudlb::pair<Key, T>;
+		using reference = cudlb::pair<Key const&, T const&>;
+		using pointer = void;
+		using difference_type = ptrdiff_t;
+
+		__device__
+		const_iterator(table const* tbl, size_t slot)
+			: tbl{ tbl }, slot{ slot }
+		{}
+
+		/**
+		*	Converts a mutable iterator into a constant one.
+		*/
+		__device__
+		const_iterator(iterator const& other)
+			: tbl{ other.tbl }, slot{ other.slot }
+		{}
+
+		__device__
+		reference operator*() const
+		{
+			return reference{ tbl->keys[slot], tbl->values[slot] };
+		}
+
+		__device__
+		const_iterator& operator++()
+		{
+			slot = tbl->next_occupied(slot + 1);
+			return *this;
+		}
+
+		__device__
+		const_iterator operator++(int)
+		{
+			const_iterator temp = *this;
+			slot = tbl->next_occupied(slot + 1);
+			return temp;
+		}
+
+		__device__
+		bool operator==(const_iterator const& other) const
+		{
+			return slot == other.slot;
+		}
+
+		__device__
+		bool operator!=(const_iterator const& other) const
+		{
+			return slot != other.slot;
+		}
+
+		table const* tbl;
+		size_t slot;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,260 @@
+#pragma once
+#include "device_hash_table.h"
+
+namespace cudlb
+{
+	/**
+	*	Unordered associative container holding unique keys.
+	*	Implemented as an open addressing hash table with linear probing, see hash_table.
+	*/
+	template<typename Key, typename Hash = cudlb::hash<Key>, typename KeyEqual = cudlb::equal_to<Key>, typename Allocator = cudlb::device_allocator<Key>>
+	class device_unordered_set : private hash_table<Key, hash_table_no_value, Hash, KeyEqual, Allocator> {
+	public:
+		using key_type = Key;
+		using value_type = Key;
+		using size_type = size_t;
+		using hasher = Hash;
+		using key_equal = KeyEqual;
+		using allocator = Allocator;
+		using table = hash_table<Key, hash_table_no_value, Hash, KeyEqual, Allocator>;
+
+		struct iterator;
+		using const_iterator = iterator;
+
+		/**
+		*	Default empty constructor, no space is allocated until the first insertion.
+		*/
+		__device__
+		device_unordered_set()
+			: table{ Hash(), KeyEqual(), Allocator() } {}
+
+		/**
+		*	Constructs an empty set with room for a user specified number of keys.
+		*	@n - number of keys that can be inserted without rehashing.
+		*	@h - hash function object.
+		*	@e - key equality function object.
+		*	@a - user specified allocator object.
+		*/
+		__device__
+		explicit device_unordered_set(size_type const n, Hash const& h = Hash(), KeyEqual const& e = KeyEqual(), Allocator const& a = Allocator())
+			: table{ h, e, a }
+		{
+			this->reserve(n);
+		}
+
+		/**
+		*	Inserts a key, if it is not in the set yet.
+		*	@key - key to insert.
+		*	Returns an iterator to the key and true if it was inserted, false if it was already present.
+		*/
+		__device__
+		cudlb::pair<iterator, bool> insert(key_type const& key)
+		{
+			auto result = this->insert_slot(key);
+			return cudlb::pair<iterator, bool>{ iterator{ this, result.first }, result.second };
+		}
+
+		/**
+		*	Looks for a key equal to @key.
+		*	@key - key to look for.
+		*	Returns an iterator to the key if found, otherwise returns end().
+		*/
+		__device__
+		iterator find(key_type const& key) const
+		{
+			size_type const i = this->find_slot(key);
+			return iterator{ this, i == table::npos ? this->slots : i };
+		}
+
+		/**
+		*	Checks if the set holds a key equal to @key.
+		*	@key - key to look for.
+		*/
+		__device__
+		bool contains(key_type const& key) const
+		{
+			return this->find_slot(key) != table::npos;
+		}
+
+		/**
+		*	Returns the number of keys equal to @key, either 0 or 1.
+		*	@key - key to look for.
+		*/
+		__device__
+		size_type count(key_type const& key) const
+		{
+			return contains(key) ? 1 : 0;
+		}
+
+		/**
+		*	Removes the key equal to @key, if there is one.
+		*	@key - key to remove.
+		*	Returns the number of keys removed, either 0 or 1.
+		*/
+		__device__
+		size_type erase(key_type const& key)
+		{
+			size_type const i = this->find_slot(key);
+			if (i == table::npos) return 0;
+			this->erase_slot(i);
+			return 1;
+		}
+
+		/**
+		*	Removes the key an iterator points to.
+		*	@pos - iterator to the key to remove, must not be end().
+		*	NOTE: Keys that followed the erased one in its probe run move back, all iterators are invalidated.
+		*/
+		__device__
+		void erase(iterator pos)
+		{
+			this->erase_slot(pos.slot);
+		}
+
+		/**
+		*	Makes room for a user specified number of keys, so that inserting them never rehashes.
+		*	@n - number of keys to make room for.
+		*/
+		__device__
+		void reserve(size_type const n)
+		{
+			table::reserve(n);
+		}
+
+		/**
+		*	Removes all keys, the allocated space is kept.
+		*/
+		__device__
+		void clear()
+		{
+			table::clear();
+		}
+
+		/**
+		*	Returns the number of keys in the set.
+		*/
+		__device__
+		size_type size() const
+		{
+			return this->occupied;
+		}
+
+		/**
+		*	Checks if the set holds no keys.
+		*/
+		__device__
+		bool empty() const
+		{
+			return this->occupied == 0;
+		}
+
+		/**
+		*	Returns the number of slots in the table.
+		*/
+		__device__
+		size_type bucket_count() const
+		{
+			return this->slots;
+		}
+
+		/**
+		*	Returns the ratio of keys to slots.
+		*/
+		__device__
+		float load_factor() const
+		{
+			return this->slots == 0 ? 0.0f : static_cast<float>(this->occupied) / static_cast<float>(this->slots);
+		}
+
+		/**
+		*	Returns the load factor above which the table grows.
+		*/
+		__device__
+		float max_load_factor() const
+		{
+			return this->max_load;
+		}
+
+		/**
+		*	Sets the load factor above which the table grows.
+		*	@ml - new maximum load factor, clamped to the range [0.05 : 0.95].
+		*/
+		__device__
+		void max_load_factor(float const ml)
+		{
+			this->set_max_load_factor(ml);
+		}
+
+		__device__
+		iterator begin() const
+		{
+			return iterator{ this, this->next_occupied(0) };
+		}
+
+		__device__
+		iterator end() const
+		{
+			return iterator{ this, this->slots };
+		}
+	};
+
+	/**
+	*	Forward iterator over the keys of a device_unordered_set, keys cannot be modified through it.
+	*/
+	template<typename Key, typename Hash, typename KeyEqual, typename Allocator>
+	struct device_unordered_set<Key, Hash, KeyEqual, Allocator>::iterator {
+		using table = hash_table<Key, hash_table_no_value, Hash, KeyEqual, Allocator>;
+		using iterator_category = cudlb::forward_iterator_tag;
+		using value_type = Key;
+		using reference = Key const&;
+		using pointer = Key const*;
+		using difference_type = ptrdiff_t;
+
+		__device__
+		iterator(table const* tbl, size_t slot)
+			: tbl{ tbl }, slot{ slot }
+		{}
+
+		__device__
+		reference operator*() const
+		{
+			return tbl->keys[slot];
+		}
+
+		__device__
+		Key const* operator->() const
+		{
+			return tbl->keys + slot;
+		}
+
+		__device__
+		iterator& operator++()
+		{
+			slot = tbl->next_occupied(slot + 1);
+			return *this;
+		}
+
+		__device__
+		iterator operator++(int)
+		{
+			iterator temp = *this;
+			slot = tbl->next_occupied(slot + 1);
+			return temp;
+		}
+
+		__device__
+		bool operator==(iterator const& other) const
+		{
+			return slot == other.slot;
+		}
+
+		__device__
+		bool operator!=(iterator const& other) const
+		{
+			return slot != other.slot;
+		}
+
+		table const* tbl;
+		size_t slot;
+	};
+}
\ No newline at end of file
@@ -1,5 +1,9 @@
 #pragma once
+#include <cstring>
 #include "device_type_traits.h"
+#if !defined(__CUDA_ARCH__) && defined(_MSC_VER)
+#include <xmmintrin.h>
+#endif
 
 namespace cudlb
 {
@@ -37,6 +41,13 @@ namespace cudlb
 		return static_cast<T&&>(arg);
 	}
 
+	/**
+	*	Names a value of type T in unevaluated operands such as decltype, without constructing one.
+	*	NOTE: Only declared, it cannot be called.
+	*/
+	template<typename T>
+	T&& declval();
+
 	/**
 	*	Returns address of an object, even if operator "&" is overloaded. 
 	*	@obj - the object we seek the address of. 
@@ -47,4 +58,120 @@ namespace cudlb
 	{
 		return reinterpret_cast<T*>(&const_cast<char&>(reinterpret_cast<char const volatile&>(obj)));
 	}
-}
\ No newline at end of file
+
+	/**
+	*	Reinterprets the object representation of @from as an object of type To.
+	*	@from - object to reinterpret, To and From must have the same size and be trivially copyable.
+	*/
+	template<typename To, typename From>
+	__host__ __device__
+	To bit_cast(From const& from)
+	{
+		static_assert(sizeof(To) == sizeof(From), "cudlb::bit_cast requires types of equal size");
+		To to;
+		memcpy(&to, &from, sizeof(To));
+		return to;
+	}
+
+	/**
+	*	Holds two objects of possibly different types as a single unit.
+	*	@first - first object.
+	*	@second - second object.
+	*/
+	template<typename T1, typename T2>
+	struct pair {
+		using first_type = T1;
+		using second_type = T2;
+
+		__host__ __device__
+		pair()
+			: first{}, second{} {}
+
+		__host__ __device__
+		pair(T1 const& a, T2 const& b)
+			: first{ a }, second{ b } {}
+
+		T1 first;
+		T2 second;
+	};
+
+	/**
+	*	Creates a pair object, deducing the types from the arguments.
+	*	@a - first object.
+	*	@b - second object.
+	*/
+	template<typename T1, typename T2>
+	__host__ __device__
+	cudlb::pair<T1, T2> make_pair(T1 const& a, T2 const& b)
+	{
+		return cudlb::pair<T1, T2>{ a, b };
+	}
+
+	/**
+	*	Hints the memory system to bring the cache line holding an address closer to the processor.
+	*	@p - address to prefetch.
+	*	NOTE: This is only a hint, it never faults and has no observable effect on program state.
+	*/
+	__host__ __device__
+	inline void prefetch(void const* p)
+	{
+	#if defined(__CUDA_ARCH__)
+		asm volatile("prefetch.L1 [%0];" :: "l"(p));
+	#elif defined(_MSC_VER)
+		_mm_prefetch(static_cast<char const*>(p), _MM_HINT_T0);
+	#else
+		__builtin_prefetch(p);
+	#endif
+	}
+
+	/**
+	*	Compile time sequence of indices, expanded by a parameter pack to unroll a loop over them.
+	*/
+	template<size_t... I>
+	struct index_sequence {
+		static constexpr size_t size = sizeof...(I);
+	};
+
+	/**
+	*	Joins two index sequences, the indices of the second one shifted past those of the first.
+	*/
+	template<typename A, typename B>
+	struct join_index_sequence;
+
+	template<size_t... I, size_t... J>
+	struct join_index_sequence<cudlb::index_sequence<I...>, cudlb::index_sequence<J...>> {
+		using type = cudlb::index_sequence<I..., (sizeof...(I) + J)...>;
+	};
+
+	/**
+	*	Builds the index sequence 0, 1, ... N - 1 from two halves, in a recursion of depth log2(N).
+	*/
+	template<size_t N>
+	struct index_sequence_of : cudlb::join_index_sequence<typename cudlb::index_sequence_of<N / 2>::type, typename cudlb::index_sequence_of<N - N / 2>::type> {};
+
+	template<>
+	struct index_sequence_of<0> {
+		using type = cudlb::index_sequence<>;
+	};
+
+	template<>
+	struct index_sequence_of<1> {
+		using type = cudlb::index_sequence<0>;
+	};
+
+	template<size_t N>
+	using make_index_sequence = typename cudlb::index_sequence_of<N>::type;
+
+	/**
+	*	Base of the nodes of element-wise expressions built by the operators of device_expression.h,
+	*	E is the type of the node. Containers take it in their assignment operators, which evaluate the expression.
+	*/
+	template<typename E>
+	struct expression {
+		__host__ __device__
+		E const& self() const
+		{
+			return static_cast<E const&>(*this);
+		}
+	};
+}
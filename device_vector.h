@@ -137,14 +137,14 @@ namespace cudlb
 		using reference = T & ;
 		using const_reference = T const&;
 		using size_type = size_t;
-		using allocator = typename Allocator; 
+		using allocator = Allocator; 
 
 		/**
 		*	Default empty constructor.
 		*/
 		__device__
 		device_vector()
-			: vector_base{} {}
+			: vector_base<T, Allocator>{} {}
 
 		/**
 		*	Constructs a vector with a user specified number of objects.
@@ -153,7 +153,7 @@ namespace cudlb
 		*/
 		__device__
 		explicit device_vector(size_type const n)
-			: vector_base{ n }
+			: vector_base<T, Allocator>{ n }
 		{
 			default_fill(this->base.begin, this->base.end);
 		}
@@ -165,7 +165,7 @@ namespace cudlb
 		*/
 		__device__
 		device_vector(size_type const n, value_type const& val)
-			: vector_base{ n }
+			: vector_base<T, Allocator>{ n }
 		{
 			fill(this->base.begin, this->base.end, val);
 		}
@@ -178,7 +178,7 @@ namespace cudlb
 		*/
 		__device__
 			device_vector(Allocator const& other, size_type const n)
-			: vector_base{ other, n }
+			: vector_base<T, Allocator>{ other, n }
 		{
 			default_fill(this->base.begin, this->base.end);
 		}
@@ -191,7 +191,7 @@ namespace cudlb
 		*/
 		__device__
 		device_vector(Allocator const& other, size_type const n, value_type const& val)
-			: vector_base{ other, n }
+			: vector_base<T, Allocator>{ other, n }
 		{
 			fill(this->base.begin, this->base.end, val);
 		}
@@ -203,7 +203,7 @@ namespace cudlb
 		*/
 		__device__ 
 		device_vector(std::initializer_list<T> const list)
-			: vector_base{ list.size() }
+			: vector_base<T, Allocator>{ list.size() }
 		{
 			cudlb::uninitialized_copy(list.begin(), list.end(), this->base.begin);
 		}
@@ -214,7 +214,7 @@ namespace cudlb
 		*/
 		__device__
 		device_vector(device_vector const& other)
-			: vector_base{ other.size() }
+			: vector_base<T, Allocator>{ other.size() }
 		{
 			cudlb::uninitialized_copy(other.begin(), other.end(), this->base.begin);
 		}
@@ -225,7 +225,7 @@ namespace cudlb
 		*/
 		__device__ 
 		device_vector(device_vector && other)
-			: vector_base{ other::allocator }
+			: vector_base<T, Allocator>{}
 		{
 			impl_shallow_copy(other); 
 			other.base.space = other.base.end = other.base.begin = nullptr; 
@@ -257,6 +257,24 @@ namespace cudlb
 			return *this; 
 		}
 
+		/**
+		*	Evaluates an element-wise expression into the vector, in a single loop without temporaries.
+		*	@e - expression built by the operators of device_expression.h, at least as long as the vector.
+		*	NOTE: The expression may refer to this vector, every element is read before it is written.
+		*	Throws without writing any element if a container of the expression is shorter than the vector.
+		*/
+		template<typename E>
+		__device__
+		device_vector const& operator=(cudlb::expression<E> const& e)
+		{
+			E const& x = e.self();
+			size_type const n = size();
+			if (x.size() != 0 && x.size() < n) throw;
+			for (size_type i = 0; i != n; ++i)
+				this->base.begin[i] = x[i];
+			return *this;
+		}
+
 		/**
 		*	Object destructor.
 		*	NOTE: If elements are pointers, this destructor does not clean up the objects pointed to by them.
@@ -0,0 +1,193 @@
+#pragma once
+#include "device_iterator.h"
+#include "device_algorithm.h"
+
+namespace cudlb
+{
+	/**
+	*	Lazy view of a sequence, a pair of iterator adaptors passed to the algorithms in place of a container.
+	*	Views own no elements and compute them as they are read, so a pipeline of views such as
+	*	"transform, filter, then reduce" runs in a single pass without temporary containers.
+	*	Views are cheap to copy and stay valid as long as the sequences they adapt.
+	*/
+	template<typename Iterator>
+	class view {
+	public:
+		using iterator = Iterator;
+		using const_iterator = Iterator;
+		using value_type = typename Iterator::value_type;
+		using reference = typename Iterator::reference;
+		using size_type = size_t;
+
+		__host__ __device__
+		view(Iterator first, Iterator last)
+			: first{ first }, last{ last }
+		{}
+
+		__host__ __device__
+		iterator begin() const
+		{
+			return first;
+		}
+
+		__host__ __device__
+		iterator end() const
+		{
+			return last;
+		}
+
+		/**
+		*	Returns the number of elements of the view.
+		*	NOTE: Takes linear time for a filtered view, which has to evaluate the predicate on every element.
+		*/
+		__host__ __device__
+		size_type size() const
+		{
+			return cudlb::iterator_traits<Iterator>::distance(first, last);
+		}
+
+		__host__ __device__
+		bool empty() const
+		{
+			return first == last;
+		}
+
+	private:
+		Iterator first;
+		Iterator last;
+	};
+
+	template<typename Iterator, typename Function>
+	using transform_view = cudlb::view<cudlb::transform_iterator<Iterator, Function>>;
+
+	template<typename Iterator, typename Predicate>
+	using filter_view = cudlb::view<cudlb::filter_iterator<Iterator, Predicate>>;
+
+	template<typename IteratorA, typename IteratorB>
+	using zip_view = cudlb::view<cudlb::zip_iterator<IteratorA, IteratorB>>;
+
+	template<typename T>
+	using counting_view = cudlb::view<cudlb::counting_iterator<T>>;
+
+	template<typename Iterator>
+	using strided_view = cudlb::view<cudlb::strided_iterator<Iterator>>;
+
+	/**
+	*	Returns a view of the results of a function applied to the elements of a sequence.
+	*	@[first : last) - sequence of elements.
+	*	@f - function applied to every element read.
+	*/
+	template<typename Iterator, typename Function>
+	__host__ __device__
+	cudlb::transform_view<Iterator, Function> make_transform_view(Iterator first, Iterator last, Function f)
+	{
+		return cudlb::transform_view<Iterator, Function>{ { first, f }, { last, f } };
+	}
+
+	/**
+	*	Returns a view of the results of a function applied to the elements of a container or another view.
+	*/
+	template<typename Range, typename Function>
+	__host__ __device__
+	auto make_transform_view(Range const& range, Function f) -> cudlb::transform_view<decltype(range.begin()), Function>
+	{
+		return cudlb::make_transform_view(range.begin(), range.end(), f);
+	}
+
+	/**
+	*	Returns a view of the elements of a sequence which satisfy a predicate.
+	*	@[first : last) - sequence of elements.
+	*	@pred - predicate, true for the elements to keep.
+	*	NOTE: A filtered view only supports forward iteration, parallel algorithms cannot take it.
+	*/
+	template<typename Iterator, typename Predicate>
+	__host__ __device__
+	cudlb::filter_view<Iterator, Predicate> make_filter_view(Iterator first, Iterator last, Predicate pred)
+	{
+		return cudlb::filter_view<Iterator, Predicate>{ { first, last, pred }, { last, last, pred } };
+	}
+
+	/**
+	*	Returns a view of the elements of a container or another view which satisfy a predicate.
+	*/
+	template<typename Range, typename Predicate>
+	__host__ __device__
+	auto make_filter_view(Range const& range, Predicate pred) -> cudlb::filter_view<decltype(range.begin()), Predicate>
+	{
+		return cudlb::make_filter_view(range.begin(), range.end(), pred);
+	}
+
+	/**
+	*	Returns a view of pairs of elements of two sequences taken in step.
+	*	@[first_a : last_a) - first sequence, which sets the length of the view.
+	*	@first_b - start of the second sequence, at least as long as the first.
+	*/
+	template<typename IteratorA, typename IteratorB>
+	__host__ __device__
+	cudlb::zip_view<IteratorA, IteratorB> make_zip_view(IteratorA first_a, IteratorA last_a, IteratorB first_b)
+	{
+		return cudlb::zip_view<IteratorA, IteratorB>{ { first_a, first_b }, { last_a, first_b + (last_a - first_a) } };
+	}
+
+	/**
+	*	Returns a view of pairs of elements of two containers or views, as long as the first one.
+	*/
+	template<typename RangeA, typename RangeB>
+	__host__ __device__
+	auto make_zip_view(RangeA const& a, RangeB const& b) -> cudlb::zip_view<decltype(a.begin()), decltype(b.begin())>
+	{
+		return cudlb::make_zip_view(a.begin(), a.end(), b.begin());
+	}
+
+	/**
+	*	Returns a view of the consecutive values [first : last).
+	*/
+	template<typename T>
+	__host__ __device__
+	cudlb::counting_view<T> make_counting_view(T const first, T const last)
+	{
+		return cudlb::counting_view<T>{ cudlb::counting_iterator<T>{ first }, cudlb::counting_iterator<T>{ last } };
+	}
+
+	/**
+	*	Returns a view of every @stride-th element of a random access sequence, starting with the first one.
+	*	@[first : last) - random access sequence of elements.
+	*	@stride - distance between the elements viewed, at least 1.
+	*/
+	template<typename Iterator>
+	__host__ __device__
+	cudlb::strided_view<Iterator> make_strided_view(Iterator first, Iterator last, ptrdiff_t const stride)
+	{
+		ptrdiff_t const count = (static_cast<ptrdiff_t>(last - first) + stride - 1) / stride;
+		return cudlb::strided_view<Iterator>{ { first, stride, 0 }, { first, stride, count } };
+	}
+
+	/**
+	*	Returns a view of every @stride-th element of a container or another random access view.
+	*/
+	template<typename Range>
+	__host__ __device__
+	auto make_strided_view(Range const& range, ptrdiff_t const stride) -> cudlb::strided_view<decltype(range.begin())>
+	{
+		return cudlb::make_strided_view(range.begin(), range.end(), stride);
+	}
+
+	/**
+	*	Compile time check that the algorithms accept views over lambdas, whose iterators they copy and assign.
+	*	Never called, it only has to compile.
+	*/
+	inline void check_lambda_views()
+	{
+		int* const p = nullptr;
+		auto const square = cudlb::make_transform_view(p, p, [](int x) { return x * x; });
+		auto const odd = cudlb::make_filter_view(p, p, [](int x) { return x % 2 != 0; });
+		(void)cudlb::lower_bound(square.begin(), square.end(), 0);
+		(void)cudlb::upper_bound(square.begin(), square.end(), 0);
+		(void)cudlb::binary_search(square.begin(), square.end(), 0);
+		(void)cudlb::equal_range(square.begin(), square.end(), 0);
+		(void)cudlb::lower_bound(odd.begin(), odd.end(), 0);
+		(void)cudlb::equal_range(odd.begin(), odd.end(), 0);
+		(void)cudlb::copy_if(square.begin(), square.end(), p, [](int x) { return x > 0; });
+		(void)cudlb::copy_if(odd.begin(), odd.end(), p, [](int x) { return x > 0; });
+	}
+}